@@ -0,0 +1,239 @@
+#ifndef A1_FAST_IO_H
+#define A1_FAST_IO_H
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Buffered writer on a file descriptor, a file opened by path, or a
+// string it appends to. Numbers are formatted with to_chars straight into
+// the buffer (floating point in general form with 6 significant digits,
+// as cout prints them), and nothing is written until the buffer fills,
+// flush() is called or the writer is destroyed.
+class FastWriter
+{
+public:
+    explicit FastWriter(int fd = 1, size_t capacity = 1 << 16)
+        : fd(fd), owned(false), memory(nullptr), buf(new char[capacity]), cap(capacity), len(0) {}
+
+    // Creates or truncates the file; check ok() before use
+    explicit FastWriter(const std::string& path, size_t capacity = 1 << 16)
+        : FastWriter(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644), capacity)
+    {
+        owned = fd >= 0;
+    }
+
+    // Appends to *target
+    explicit FastWriter(std::string* target, size_t capacity = 1 << 16)
+        : FastWriter(-1, capacity)
+    {
+        memory = target;
+    }
+
+    ~FastWriter()
+    {
+        flush();
+        if (owned) close(fd);
+        delete[] buf;
+    }
+
+    FastWriter(const FastWriter&) = delete;
+    FastWriter& operator=(const FastWriter&) = delete;
+
+    bool ok() const { return fd >= 0 || memory; }
+
+    void flush()
+    {
+        writeAll(buf, len);
+        len = 0;
+    }
+
+    void write(const char* s, size_t n)
+    {
+        if (n > cap - len)
+        {
+            flush();
+            if (n > cap)  // too big to buffer, write it through
+            {
+                writeAll(s, n);
+                return;
+            }
+        }
+        memcpy(buf + len, s, n);
+        len += n;
+    }
+
+    FastWriter& operator<<(char c)
+    {
+        if (len == cap) flush();
+        buf[len++] = c;
+        return *this;
+    }
+    FastWriter& operator<<(const char* s)
+    {
+        write(s, strlen(s));
+        return *this;
+    }
+    FastWriter& operator<<(const std::string& s)
+    {
+        write(s.data(), s.size());
+        return *this;
+    }
+    template <class T, class = typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value>::type>
+    FastWriter& operator<<(T value)
+    {
+        if (cap - len < 24) flush();
+        len = std::to_chars(buf + len, buf + cap, value).ptr - buf;
+        return *this;
+    }
+    FastWriter& operator<<(double value)
+    {
+        if (cap - len < 32) flush();
+        len = std::to_chars(buf + len, buf + cap, value, std::chars_format::general, 6).ptr - buf;
+        return *this;
+    }
+    FastWriter& operator<<(float value) { return *this << (double)value; }
+
+private:
+    int fd;
+    bool owned;
+    std::string* memory;
+    char* buf;
+    size_t cap, len;
+
+    void writeAll(const char* p, size_t n)
+    {
+        if (n == 0) return;
+        if (memory)
+        {
+            memory->append(p, n);
+            return;
+        }
+        // whatever cout or printf still holds for stdout goes first
+        if (fd == 1) std::fflush(stdout);
+        while (n > 0)
+        {
+            ssize_t done = ::write(fd, p, n);
+            if (done <= 0) break;
+            p += done;
+            n -= done;
+        }
+    }
+};
+
+// Buffered reader on a file descriptor with from_chars integer parsing.
+// A tied writer is flushed before every blocking read, so prompts still
+// show up in interactive use.
+class FastReader
+{
+public:
+    explicit FastReader(int fd = 0, FastWriter* tied = nullptr, size_t capacity = 1 << 16)
+        : fd(fd), tied(tied), buf(new char[capacity]), cap(capacity), pos(0), len(0), atEnd(false) {}
+
+    ~FastReader() { delete[] buf; }
+
+    FastReader(const FastReader&) = delete;
+    FastReader& operator=(const FastReader&) = delete;
+
+    // Skips whitespace and parses one integer; false at end of input or
+    // when the next token is not a number of type T
+    template <class T>
+    bool readInt(T& value)
+    {
+        if (!skipSpace()) return false;
+        // near the end of the buffer, make sure the whole token is loaded
+        // (no integer needs 32 characters, so the check is rarely taken)
+        size_t end = pos;
+        while (len - pos < 32)
+        {
+            while (end < len && !isSpace(buf[end])) end++;
+            if (end < len) break;
+            size_t before = pos;
+            if (!refill()) break;
+            end -= before;
+        }
+        auto parsed = std::from_chars(buf + pos, buf + len, value);
+        if (parsed.ec != std::errc()) return false;
+        pos = parsed.ptr - buf;
+        return true;
+    }
+
+    // Next whitespace separated token
+    bool readToken(std::string& token)
+    {
+        token.clear();
+        if (!skipSpace()) return false;
+        while (true)
+        {
+            size_t start = pos;
+            while (pos < len && !isSpace(buf[pos])) pos++;
+            token.append(buf + start, pos - start);
+            if (pos < len || !refill()) return true;
+        }
+    }
+
+    // Rest of the current line without the line break; false at end of input
+    bool readLine(std::string& line)
+    {
+        line.clear();
+        if (pos == len && !refill()) return false;
+        while (true)
+        {
+            const char* nl = (const char*)memchr(buf + pos, '\n', len - pos);
+            size_t end = nl ? nl - buf : len;
+            line.append(buf + pos, end - pos);
+            pos = end;
+            if (nl)
+            {
+                pos++;
+                break;
+            }
+            if (!refill()) break;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return true;
+    }
+
+private:
+    int fd;
+    FastWriter* tied;
+    char* buf;
+    size_t cap, pos, len;
+    bool atEnd;
+
+    static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+    bool skipSpace()
+    {
+        while (true)
+        {
+            while (pos < len && isSpace(buf[pos])) pos++;
+            if (pos < len) return true;
+            if (!refill()) return false;
+        }
+    }
+
+    // Keeps the unread bytes and appends more input after them
+    bool refill()
+    {
+        if (atEnd) return false;
+        if (tied) tied->flush();
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        pos = 0;
+        ssize_t n = ::read(fd, buf + len, cap - len);
+        if (n <= 0)
+        {
+            atEnd = true;
+            return false;
+        }
+        len += n;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include "A1_fast_io.h"
+using namespace std;
+
+// Compares iostreams with FastReader / FastWriter on N integers.
+// Usage: A1_fast_io_bench [count] [scratch file]
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    string path = argc > 2 ? argv[2] : "/tmp/A1_fast_io_bench.txt";
+    vector<int> values(count);
+    uint32_t seed = 2463534242u;
+    for (int& x : values)
+    {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        x = (int)seed;
+    }
+    auto time = [](const char* label, auto body)
+    {
+        auto start = chrono::steady_clock::now();
+        long long checksum = body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << label << ": " << seconds * 1000 << " ms (checksum " << checksum << ")" << endl;
+        return seconds;
+    };
+
+    double endlWrite = time("write, ofstream << endl ", [&]
+    {
+        ofstream file(path);
+        for (int x : values) file << x << endl;
+        return (long long)values.size();
+    });
+    double newlineWrite = time("write, ofstream << '\\n'", [&]
+    {
+        ofstream file(path);
+        for (int x : values) file << x << '\n';
+        return (long long)values.size();
+    });
+    double fastWrite = time("write, FastWriter      ", [&]
+    {
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        {
+            FastWriter out(fd, 1 << 20);
+            for (int x : values) out << x << '\n';
+        }
+        close(fd);
+        return (long long)values.size();
+    });
+    double streamRead = time("read,  ifstream >>       ", [&]
+    {
+        ifstream file(path);
+        long long sum = 0;
+        int x;
+        while (file >> x) sum += x;
+        return sum;
+    });
+    double fastRead = time("read,  FastReader        ", [&]
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        long long sum = 0;
+        {
+            FastReader in(fd, nullptr, 1 << 20);
+            int x;
+            while (in.readInt(x)) sum += x;
+        }
+        close(fd);
+        return sum;
+    });
+    cout << "Write speedup: x" << endlWrite / fastWrite << " vs endl, x" << newlineWrite / fastWrite << " vs '\\n'" << endl;
+    cout << "Read speedup: x" << streamRead / fastRead << endl;
+    unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,389 @@
+#ifndef A1_MATRIX_H
+#define A1_MATRIX_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Row-major rows x cols matrix in one heap block. Cells are
+// default-initialised, so for int and friends no page is touched until
+// the first write, and a large matrix costs nothing up front.
+template <class T>
+class Matrix
+{
+public:
+    Matrix() : r(0), c(0) {}
+    Matrix(size_t rows, size_t cols) : r(rows), c(cols), cells(new T[rows * cols]) {}
+
+    Matrix(Matrix&&) = default;
+    Matrix& operator=(Matrix&&) = default;
+
+    size_t rows() const { return r; }
+    size_t cols() const { return c; }
+    size_t size() const { return r * c; }
+
+    T* data() { return cells.get(); }
+    const T* data() const { return cells.get(); }
+
+    // matrix[i][j], the row is a plain pointer
+    T* operator[](size_t i) { return cells.get() + i * c; }
+    const T* operator[](size_t i) const { return cells.get() + i * c; }
+
+private:
+    size_t r, c;
+    std::unique_ptr<T[]> cells;
+};
+
+// A rows x cols window onto cells of a Matrix (or any strided memory):
+// element (i, j) is origin[i * rowStep + j * colStep]. Rotations, flips,
+// transposes and sub-blocks only change origin, shape and steps, so they
+// compose without moving any data; materialize() copies out the cells in
+// row-major order when a consumer needs contiguous rows.
+template <class T>
+class MatrixView
+{
+public:
+    MatrixView(T* origin, size_t rows, size_t cols, ptrdiff_t rowStep, ptrdiff_t colStep)
+        : origin(origin), r(rows), c(cols), rowStep(rowStep), colStep(colStep) {}
+
+    // A view of T is also a read-only view of const T
+    template <class U, class = typename std::enable_if<std::is_same<const U, T>::value>::type>
+    MatrixView(const MatrixView<U>& other)
+        : MatrixView(other.data(), other.rows(), other.cols(), other.rowStride(), other.colStride()) {}
+
+    // Cell (0, 0)
+    T* data() const { return origin; }
+
+    size_t rows() const { return r; }
+    size_t cols() const { return c; }
+    size_t size() const { return r * c; }
+    ptrdiff_t rowStride() const { return rowStep; }
+    ptrdiff_t colStride() const { return colStep; }
+
+    T& operator()(size_t i, size_t j) const { return origin[(ptrdiff_t)i * rowStep + (ptrdiff_t)j * colStep]; }
+
+    MatrixView transposed() const { return MatrixView(origin, c, r, colStep, rowStep); }
+
+    // Upside down
+    MatrixView flippedRows() const
+    {
+        return r == 0 ? *this : MatrixView(&(*this)(r - 1, 0), r, c, -rowStep, colStep);
+    }
+
+    // Left to right
+    MatrixView flippedCols() const
+    {
+        return c == 0 ? *this : MatrixView(&(*this)(0, c - 1), r, c, rowStep, -colStep);
+    }
+
+    // Turned clockwise by a multiple of 90 degrees
+    MatrixView rotated(int degrees) const
+    {
+        switch ((degrees % 360 + 360) % 360)
+        {
+        case 90: return transposed().flippedCols();
+        case 180: return flippedRows().flippedCols();
+        case 270: return transposed().flippedRows();
+        default: return *this;
+        }
+    }
+
+    // rows x cols cells starting at (row, col)
+    MatrixView block(size_t row, size_t col, size_t rows, size_t cols) const
+    {
+        return MatrixView(rows && cols ? &(*this)(row, col) : origin, rows, cols, rowStep, colStep);
+    }
+
+    // Writes the cells to dest in row-major order. Rows that are runs in
+    // memory are one memcpy; otherwise the copy goes in 32x32 blocks so
+    // the strided reads stay within a few cache lines per block.
+    void copyTo(typename std::remove_const<T>::type* dest) const
+    {
+        if (colStep == 1)
+        {
+            for (size_t i = 0; i < r; i++)
+                if (c) std::memcpy(dest + i * c, &(*this)(i, 0), c * sizeof(T));
+            return;
+        }
+        const size_t B = 32;
+        for (size_t i0 = 0; i0 < r; i0 += B)
+            for (size_t j0 = 0; j0 < c; j0 += B)
+                for (size_t i = i0; i < std::min(r, i0 + B); i++)
+                    for (size_t j = j0; j < std::min(c, j0 + B); j++)
+                        dest[i * c + j] = (*this)(i, j);
+    }
+
+    // Contiguous row-major copy
+    Matrix<typename std::remove_const<T>::type> materialize() const
+    {
+        Matrix<typename std::remove_const<T>::type> result(r, c);
+        copyTo(result.data());
+        return result;
+    }
+
+private:
+    T* origin;
+    size_t r, c;
+    ptrdiff_t rowStep, colStep;
+};
+
+template <class T>
+MatrixView<T> view(Matrix<T>& matrix)
+{
+    return MatrixView<T>(matrix.data(), matrix.rows(), matrix.cols(), matrix.cols(), 1);
+}
+
+template <class T>
+MatrixView<const T> view(const Matrix<T>& matrix)
+{
+    return MatrixView<const T>(matrix.data(), matrix.rows(), matrix.cols(), matrix.cols(), 1);
+}
+
+// Reads the size line of a typed-in matrix from a line reader (FastReader):
+// "rows cols", or a single n for an n x n matrix as the tools first asked
+// for. Blank lines are skipped; false at end of input or when the line is
+// not one or two sizes.
+template <class Reader>
+bool readMatrixSize(Reader& in, size_t& rows, size_t& cols)
+{
+    std::string line;
+    while (in.readLine(line))
+    {
+        size_t size[2];
+        int count = 0;
+        const char* p = line.data();
+        const char* end = p + line.size();
+        while (true)
+        {
+            while (p < end && (*p == ' ' || *p == '\t')) p++;
+            if (p == end) break;
+            if (count == 2) return false;
+            auto parsed = std::from_chars(p, end, size[count++]);
+            if (parsed.ec != std::errc() || (parsed.ptr < end && *parsed.ptr != ' ' && *parsed.ptr != '\t')) return false;
+            p = parsed.ptr;
+        }
+        if (count == 0) continue;
+        rows = size[0];
+        cols = size[count - 1];
+        return true;
+    }
+    return false;
+}
+
+// Binary matrix file: a 64-byte header, then rows x cols cells in
+// row-major order at dataOffset, which is a multiple of alignment (a page,
+// so the cells can be mapped and used in place with aligned loads).
+// Numbers are in the writer's byte order; endianTag tells a reader on a
+// machine with the other order that it cannot use the file as is.
+enum MatrixElement : uint8_t
+{
+    MATRIX_INT32 = 1,
+    MATRIX_INT64 = 2,
+    MATRIX_FLOAT32 = 3,
+    MATRIX_FLOAT64 = 4
+};
+
+struct MatrixFileHeader
+{
+    char magic[4];        // "A1MX"
+    uint16_t version;     // MATRIX_FILE_VERSION
+    uint8_t elementType;  // MatrixElement
+    uint8_t elementSize;  // bytes per cell
+    uint32_t alignment;   // of dataOffset, a power of two
+    uint32_t endianTag;   // 0x01020304
+    uint64_t rows, cols;
+    uint64_t dataOffset;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(MatrixFileHeader) == 64, "matrix file header must be 64 bytes");
+
+const uint16_t MATRIX_FILE_VERSION = 1;
+const uint32_t MATRIX_FILE_ALIGNMENT = 4096;
+
+template <class T> struct MatrixElementOf;
+template <> struct MatrixElementOf<int32_t> { static const uint8_t value = MATRIX_INT32; };
+template <> struct MatrixElementOf<int64_t> { static const uint8_t value = MATRIX_INT64; };
+template <> struct MatrixElementOf<float> { static const uint8_t value = MATRIX_FLOAT32; };
+template <> struct MatrixElementOf<double> { static const uint8_t value = MATRIX_FLOAT64; };
+
+inline size_t matrixElementSize(uint8_t type)
+{
+    return type == MATRIX_INT32 || type == MATRIX_FLOAT32 ? 4 : type == MATRIX_INT64 || type == MATRIX_FLOAT64 ? 8 : 0;
+}
+
+// Reads and checks the header of a matrix file of any element type; null
+// when it is fine, otherwise what is wrong. fileSize is the size of the
+// whole file, so a truncated one is caught here too.
+inline const char* checkMatrixHeader(const MatrixFileHeader& header, uint64_t fileSize)
+{
+    if (fileSize < sizeof(header) || std::memcmp(header.magic, "A1MX", 4) != 0) return "not a matrix file";
+    if (header.endianTag != 0x01020304) return "written with the other byte order";
+    if (header.version != MATRIX_FILE_VERSION) return "unsupported matrix file version";
+    size_t size = matrixElementSize(header.elementType);
+    if (size == 0 || size != header.elementSize) return "unknown element type";
+    if (header.alignment == 0 || (header.alignment & (header.alignment - 1)) != 0 || header.dataOffset % header.alignment != 0 ||
+        header.dataOffset % size != 0 || header.dataOffset < sizeof(header))
+        return "bad data offset";
+    if (header.cols != 0 && header.rows > (UINT64_MAX / size) / header.cols) return "matrix too large";
+    if (fileSize < header.dataOffset || fileSize - header.dataOffset < header.rows * header.cols * size) return "file is truncated";
+    return nullptr;
+}
+
+inline const char* readMatrixHeader(const char* path, MatrixFileHeader& header)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return "cannot open file";
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+    close(fd);
+    return ok ? checkMatrixHeader(header, st.st_size) : "not a matrix file";
+}
+
+// True when both paths name one existing file, through links too.
+// Creating a MappedMatrix truncates its file, so a tool must not create
+// one over a file it is still reading.
+inline bool isSameFile(const char* a, const char* b)
+{
+    struct stat sa, sb;
+    return stat(a, &sa) == 0 && stat(b, &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+// A matrix file mapped into memory. Opening maps an existing file
+// read-only, and pages are loaded as they are touched, so a tool can work
+// on a matrix larger than RAM without a load step. Creating sizes a new
+// file for rows x cols cells and maps it shared, so whatever is written
+// to data() ends up in the file. error() says why a file could not be
+// used; the matrix is empty then.
+template <class T>
+class MappedMatrix
+{
+public:
+    explicit MappedMatrix(const char* path) : MappedMatrix()
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            problem = "cannot open file";
+            return;
+        }
+        map(fd, false);
+        close(fd);
+        if (problem) return;
+        const MatrixFileHeader* header = (const MatrixFileHeader*)base;
+        if (header->elementType != MatrixElementOf<T>::value)
+            problem = "wrong element type";
+        else
+        {
+            r = header->rows;
+            c = header->cols;
+            cells = (T*)(base + header->dataOffset);
+        }
+        if (problem) unmap();
+    }
+
+    MappedMatrix(const char* path, size_t rows, size_t cols) : MappedMatrix()
+    {
+        MatrixFileHeader header = {};
+        std::memcpy(header.magic, "A1MX", 4);
+        header.version = MATRIX_FILE_VERSION;
+        header.elementType = MatrixElementOf<T>::value;
+        header.elementSize = sizeof(T);
+        header.alignment = MATRIX_FILE_ALIGNMENT;
+        header.endianTag = 0x01020304;
+        header.rows = rows;
+        header.cols = cols;
+        header.dataOffset = MATRIX_FILE_ALIGNMENT;
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || ftruncate(fd, header.dataOffset + rows * cols * sizeof(T)) != 0 ||
+            pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+            problem = "cannot write file";
+        else
+            map(fd, true);
+        if (fd >= 0) close(fd);
+        if (problem) return;
+        r = rows;
+        c = cols;
+        cells = (T*)(base + header.dataOffset);
+    }
+
+    ~MappedMatrix() { unmap(); }
+
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    const char* error() const { return problem; }
+
+    size_t rows() const { return r; }
+    size_t cols() const { return c; }
+    size_t size() const { return r * c; }
+
+    T* data() { return cells; }
+    const T* data() const { return cells; }
+
+    void advise(int advice) const
+    {
+        if (base) madvise(base, length, advice);
+    }
+
+private:
+    char* base;
+    size_t length;
+    T* cells;
+    size_t r, c;
+    const char* problem;
+
+    MappedMatrix() : base(nullptr), length(0), cells(nullptr), r(0), c(0), problem(nullptr) {}
+
+    void map(int fd, bool writable)
+    {
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            problem = "cannot read file";
+            return;
+        }
+        length = st.st_size;
+        if (!writable && length < sizeof(MatrixFileHeader))
+        {
+            problem = "not a matrix file";
+            return;
+        }
+        void* p = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            problem = "cannot map file";
+            return;
+        }
+        base = (char*)p;
+        if (!writable) problem = checkMatrixHeader(*(const MatrixFileHeader*)base, length);
+    }
+
+    void unmap()
+    {
+        if (base) munmap(base, length);
+        base = nullptr;
+    }
+};
+
+template <class T>
+MatrixView<T> view(MappedMatrix<T>& matrix)
+{
+    return MatrixView<T>(matrix.data(), matrix.rows(), matrix.cols(), matrix.cols(), 1);
+}
+
+template <class T>
+MatrixView<const T> view(const MappedMatrix<T>& matrix)
+{
+    return MatrixView<const T>(matrix.data(), matrix.rows(), matrix.cols(), matrix.cols(), 1);
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "A1_fast_io.h"
+#include "A1_matrix.h"
+using namespace std;
+
+// Converts between the text matrix input of the matrix tools (a size line
+// of "rows cols" or n for n x n, then the cells row by row) and the binary
+// matrix file of A1_matrix.h.
+// Usage:
+//   A1_matrix_convert --to-binary [--type int32|int64|float32|float64] text binary
+//   A1_matrix_convert --to-text binary text
+// A text path of "-" is standard input or output.
+
+template <class T>
+bool readCell(FastReader& in, T& value)
+{
+    if constexpr (is_integral<T>::value)
+        return in.readInt(value);
+    else
+    {
+        string token;
+        if (!in.readToken(token)) return false;
+        auto parsed = from_chars(token.data(), token.data() + token.size(), value);
+        return parsed.ec == errc() && parsed.ptr == token.data() + token.size();
+    }
+}
+
+template <class T>
+void writeCell(FastWriter& out, T value)
+{
+    if constexpr (is_integral<T>::value)
+        out << value;
+    else
+    {
+        char text[32];
+        out.write(text, to_chars(text, text + sizeof(text), value).ptr - text);
+    }
+}
+
+// The cells are parsed straight into the pages of the new file
+template <class T>
+int toBinary(int textFd, const char* binaryPath)
+{
+    FastReader in(textFd, nullptr, 1 << 20);
+    size_t rows = 0, cols = 0;
+    if (!readMatrixSize(in, rows, cols))
+    {
+        cerr << "Expected the matrix size as n or as rows cols on the first line" << endl;
+        return 1;
+    }
+    MappedMatrix<T> matrix(binaryPath, rows, cols);
+    if (matrix.error())
+    {
+        cerr << binaryPath << ": " << matrix.error() << endl;
+        return 1;
+    }
+    T* cell = matrix.data();
+    for (size_t k = 0; k < matrix.size(); k++)
+    {
+        if (!readCell(in, cell[k]))
+        {
+            cerr << "Bad or missing cell " << k / cols << " " << k % cols << endl;
+            unlink(binaryPath);  // no half-filled matrix file is left behind
+            return 1;
+        }
+    }
+    string extra;
+    if (in.readToken(extra))
+    {
+        cerr << "More than " << rows << " x " << cols << " cells" << endl;
+        unlink(binaryPath);
+        return 1;
+    }
+    return 0;
+}
+
+template <class T>
+int toText(const char* binaryPath, int textFd)
+{
+    MappedMatrix<T> matrix(binaryPath);
+    if (matrix.error())
+    {
+        cerr << binaryPath << ": " << matrix.error() << endl;
+        return 1;
+    }
+    matrix.advise(MADV_SEQUENTIAL);
+    FastWriter out(textFd, 1 << 20);
+    out << matrix.rows() << ' ' << matrix.cols() << '\n';
+    for (size_t i = 0; i < matrix.rows(); i++)
+    {
+        const T* row = matrix.data() + i * matrix.cols();
+        for (size_t j = 0; j < matrix.cols(); j++)
+        {
+            if (j) out << ' ';
+            writeCell(out, row[j]);
+        }
+        out << '\n';
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    string mode = argc > 1 ? argv[1] : "";
+    string type = "int32";
+    int arg = 2;
+    if (mode == "--to-binary" && argc > 3 && string(argv[2]) == "--type")
+    {
+        type = argv[3];
+        arg = 4;
+    }
+    if ((mode != "--to-binary" && mode != "--to-text") || argc != arg + 2)
+    {
+        cerr << "Usage: " << argv[0] << " --to-binary [--type int32|int64|float32|float64] text binary" << endl;
+        cerr << "       " << argv[0] << " --to-text binary text" << endl;
+        return 1;
+    }
+    // the output file is truncated first, so it must not be the input
+    const char* from = argv[arg];
+    const char* to = argv[arg + 1];
+    if (string(from) != "-" && string(to) != "-" && isSameFile(from, to))
+    {
+        cerr << to << ": same file as the input" << endl;
+        return 1;
+    }
+
+    if (mode == "--to-binary")
+    {
+        const char* textPath = argv[arg];
+        int fd = string(textPath) == "-" ? 0 : open(textPath, O_RDONLY);
+        if (fd < 0)
+        {
+            cerr << "Cannot read " << textPath << endl;
+            return 1;
+        }
+        const char* binaryPath = argv[arg + 1];
+        int status;
+        if (type == "int32") status = toBinary<int32_t>(fd, binaryPath);
+        else if (type == "int64") status = toBinary<int64_t>(fd, binaryPath);
+        else if (type == "float32") status = toBinary<float>(fd, binaryPath);
+        else if (type == "float64") status = toBinary<double>(fd, binaryPath);
+        else
+        {
+            cerr << "Unknown element type " << type << endl;
+            status = 1;
+        }
+        if (fd != 0) close(fd);
+        return status;
+    }
+
+    const char* binaryPath = argv[arg];
+    MatrixFileHeader header;
+    if (const char* problem = readMatrixHeader(binaryPath, header))
+    {
+        cerr << binaryPath << ": " << problem << endl;
+        return 1;
+    }
+    const char* textPath = argv[arg + 1];
+    int fd = string(textPath) == "-" ? 1 : open(textPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        cerr << "Cannot write " << textPath << endl;
+        return 1;
+    }
+    int status = 1;
+    switch (header.elementType)
+    {
+    case MATRIX_INT32: status = toText<int32_t>(binaryPath, fd); break;
+    case MATRIX_INT64: status = toText<int64_t>(binaryPath, fd); break;
+    case MATRIX_FLOAT32: status = toText<float>(binaryPath, fd); break;
+    case MATRIX_FLOAT64: status = toText<double>(binaryPath, fd); break;
+    }
+    if (fd != 1) close(fd);
+    return status;
+}
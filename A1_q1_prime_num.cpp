@@ -1,63 +1,823 @@
 #include <iostream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <charconv>
+#include <chrono>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "A1_thread_pool.h"
+#include "A1_fast_io.h"
 using namespace std;
-int main() 
+
+// Integer square root (floor) for 64-bit values
+uint64_t isqrt64(uint64_t n)
 {
-    int num;
-    cout<<"Enter a positive integer: "; 
-    cin>>num;
-    int flag =1;
-    if (num <= 1) //checking if -ve 
-    { 
-        cout<<"Wrong Input !"<<endl;
-    } 
-    for (int i = 2; i < num/2; i++) 
-    { 
-        if (num % i == 0) 
+    uint64_t r = (uint64_t)sqrtl((long double)n);
+    while (r > 0 && (r > 0xFFFFFFFFULL || r * r > n)) r--;
+    while (r < 0xFFFFFFFFULL && (r + 1) * (r + 1) <= n) r++;
+    return r;
+}
+
+// Segmented Sieve of Eratosthenes over the odd numbers (one bit per odd).
+// Each segment is 32 KB so it stays in L1, and base primes are only cached
+// up to cacheLimit; larger base primes are regenerated segment by segment,
+// so memory stays bounded no matter how big the queried numbers are.
+class SegmentedSieve
+{
+public:
+    static const uint64_t SEGMENT_BYTES = 32 * 1024;
+    static const uint64_t SEGMENT_BITS = SEGMENT_BYTES * 8;
+    static const uint64_t SEGMENT_SPAN = SEGMENT_BITS * 2;  // numbers covered by one segment
+
+    explicit SegmentedSieve(uint32_t limit = 1 << 20)
+        : cacheLimit(max<uint32_t>(limit, 1 << 17)), bits(SEGMENT_BITS / 64), innerBits(SEGMENT_BITS / 64)
+    {
+        // plain sieve for the cached base primes (odd ones only, 2 is handled separately)
+        vector<char> composite(cacheLimit + 1, 0);
+        for (uint64_t i = 3; i <= cacheLimit; i += 2)
+        {
+            if (composite[i]) continue;
+            smallPrimes.push_back((uint32_t)i);
+            for (uint64_t j = i * i; j <= cacheLimit; j += 2 * i)
+                composite[j] = 1;
+        }
+    }
+
+    uint64_t cachedLimit() const { return cacheLimit; }
+
+    bool isPrime(uint64_t n)
+    {
+        if (n < 2) return false;
+        if (n % 2 == 0) return n == 2;
+        if (n <= cacheLimit) return binary_search(smallPrimes.begin(), smallPrimes.end(), (uint32_t)n);
+        uint64_t base = n - n % SEGMENT_SPAN;
+        sieveSegment(base, bits);
+        return testBit(bits, (n - base) >> 1);
+    }
+
+    // Smallest prime greater than n, or 0 if it does not fit in 64 bits
+    uint64_t nextPrime(uint64_t n)
+    {
+        if (n < 2) return 2;
+        if (n >= 18446744073709551557ULL) return 0;  // largest 64-bit prime
+        if (n < smallPrimes.back()) return *upper_bound(smallPrimes.begin(), smallPrimes.end(), (uint32_t)n);
+        uint64_t from = n + 1;
+        uint64_t base = from - from % SEGMENT_SPAN;
+        uint64_t index = (from - base) >> 1;
+        while (true)
+        {
+            sieveSegment(base, bits);
+            for (uint64_t w = index / 64; w < bits.size(); w++)
+            {
+                uint64_t word = bits[w];
+                if (w == index / 64) word &= ~0ULL << (index % 64);
+                if (word) return base + 2 * (w * 64 + __builtin_ctzll(word)) + 1;
+            }
+            base += SEGMENT_SPAN;
+            index = 0;
+        }
+    }
+
+    // Number of primes in [lo, hi]
+    uint64_t countPrimes(uint64_t lo, uint64_t hi)
+    {
+        uint64_t count = 0;
+        forEachSegment(lo, hi, [&](uint64_t, uint64_t first, uint64_t last)
+        {
+            count += countBits(bits, first, last);
+        });
+        return count + (lo <= 2 && hi >= 2);
+    }
+
+    // Calls f(p) for every prime p in [lo, hi] in increasing order
+    template <class F>
+    void forEachPrime(uint64_t lo, uint64_t hi, F f)
+    {
+        if (lo <= 2 && hi >= 2) f((uint64_t)2);
+        forEachSegment(lo, hi, [&](uint64_t base, uint64_t first, uint64_t last)
+        {
+            for (uint64_t w = first / 64; w <= last / 64; w++)
+            {
+                uint64_t word = bits[w];
+                if (w == first / 64) word &= ~0ULL << (first % 64);
+                if (w == last / 64 && last % 64 != 63) word &= (1ULL << (last % 64 + 1)) - 1;
+                while (word)
+                {
+                    f(base + 2 * (w * 64 + __builtin_ctzll(word)) + 1);
+                    word &= word - 1;
+                }
+            }
+        });
+    }
+
+private:
+    uint32_t cacheLimit;
+    vector<uint32_t> smallPrimes;  // odd primes <= cacheLimit
+    vector<uint64_t> bits;         // current segment, bit i <=> base + 2i + 1 is prime
+    vector<uint64_t> innerBits;    // scratch segment used to produce base primes > cacheLimit
+
+    static uint64_t countBits(const vector<uint64_t>& b, uint64_t first, uint64_t last)
+    {
+        uint64_t count = 0;
+        for (uint64_t w = first / 64; w <= last / 64; w++)
+        {
+            uint64_t word = b[w];
+            if (w == first / 64) word &= ~0ULL << (first % 64);
+            if (w == last / 64 && last % 64 != 63) word &= (1ULL << (last % 64 + 1)) - 1;
+            count += __builtin_popcountll(word);
+        }
+        return count;
+    }
+
+    // Works with the offset of the first multiple from base rather than the
+    // multiple itself, which may not fit in 64 bits in the top segment
+    static void crossOff(vector<uint64_t>& b, uint64_t base, uint64_t p)
+    {
+        uint64_t offset;
+        if (p * p >= base)
+            offset = p * p - base;
+        else
+        {
+            uint64_t r = base % p;
+            offset = r ? p - r : 0;
+        }
+        if (offset % 2 == 0) offset += p;  // base is even, so this is the first odd multiple
+        for (uint64_t i = offset >> 1; i < SEGMENT_BITS; i += p)
+            b[i / 64] &= ~(1ULL << (i % 64));
+    }
+
+    // Sieves [base, base + SEGMENT_SPAN) using only the cached primes up to limit
+    void sieveWithCache(uint64_t base, vector<uint64_t>& b, uint64_t limit)
+    {
+        fill(b.begin(), b.end(), ~0ULL);
+        if (base == 0) b[0] &= ~1ULL;  // 1 is not prime
+        for (uint32_t p : smallPrimes)
+        {
+            if (p > limit) break;
+            crossOff(b, base, p);
+        }
+    }
+
+public:
+    static bool testBit(const vector<uint64_t>& b, uint64_t i) { return (b[i / 64] >> (i % 64)) & 1; }
+
+    // Sieves [base, base + SEGMENT_SPAN) into b (base must be a multiple of SEGMENT_SPAN)
+    void sieveSegment(uint64_t base, vector<uint64_t>& b)
+    {
+        uint64_t limit = isqrt64(base + SEGMENT_SPAN - 1);
+        sieveWithCache(base, b, limit);
+        if (limit <= cacheLimit) return;
+        // base primes beyond the cache come from a second segmented pass,
+        // whose own base primes (< 2^16) are always cached
+        for (uint64_t innerBase = cacheLimit - cacheLimit % SEGMENT_SPAN; innerBase <= limit; innerBase += SEGMENT_SPAN)
+        {
+            sieveWithCache(innerBase, innerBits, isqrt64(innerBase + SEGMENT_SPAN - 1));
+            for (uint64_t w = 0; w < innerBits.size(); w++)
+            {
+                uint64_t word = innerBits[w];
+                while (word)
+                {
+                    uint64_t p = innerBase + 2 * (w * 64 + __builtin_ctzll(word)) + 1;
+                    word &= word - 1;
+                    if (p <= cacheLimit) continue;
+                    if (p > limit) break;
+                    crossOff(b, base, p);
+                }
+            }
+        }
+    }
+
+private:
+    // Sieves every segment overlapping [lo, hi] and calls f(base, firstBit, lastBit)
+    template <class F>
+    void forEachSegment(uint64_t lo, uint64_t hi, F f)
+    {
+        if (hi < 3) return;
+        if (lo < 3) lo = 3;
+        if (lo % 2 == 0) lo++;
+        if (hi % 2 == 0) hi--;
+        if (lo > hi) return;
+        for (uint64_t base = lo - lo % SEGMENT_SPAN; ; base += SEGMENT_SPAN)
         {
-            flag=0;
-            break;
+            uint64_t top = base + SEGMENT_SPAN - 1;
+            sieveSegment(base, bits);
+            uint64_t first = (max(lo, base) - base) >> 1;
+            uint64_t last = (min(hi, top) - base) >> 1;
+            f(base, first, last);
+            if (hi <= top) break;
         }
     }
-    if (flag==0)
+};
+
+// 64-bit Montgomery arithmetic modulo an odd n
+struct Montgomery
+{
+    uint64_t n, inv, r2;  // inv = n^-1 mod 2^64, r2 = 2^128 mod n
+
+    explicit Montgomery(uint64_t mod) : n(mod)
+    {
+        inv = n;
+        for (int i = 0; i < 5; i++) inv *= 2 - n * inv;  // Newton steps double the correct bits
+        uint64_t r1 = (0 - n) % n;
+        r2 = (uint64_t)((unsigned __int128)r1 * r1 % n);
+    }
+    uint64_t reduce(unsigned __int128 t) const
+    {
+        uint64_t m = (uint64_t)t * inv;
+        uint64_t hi = (uint64_t)(t >> 64), mn = (uint64_t)(((unsigned __int128)m * n) >> 64);
+        return hi >= mn ? hi - mn : hi - mn + n;
+    }
+    uint64_t to(uint64_t x) const { return reduce((unsigned __int128)(x % n) * r2); }
+    uint64_t from(uint64_t x) const { return reduce(x); }
+    uint64_t mul(uint64_t a, uint64_t b) const { return reduce((unsigned __int128)a * b); }
+    uint64_t add(uint64_t a, uint64_t b) const { return a >= n - b ? a - (n - b) : a + b; }
+    uint64_t pow(uint64_t a, uint64_t e) const
+    {
+        uint64_t result = to(1);
+        while (e)
+        {
+            if (e & 1) result = mul(result, a);
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return result;
+    }
+};
+
+// Deterministic Miller-Rabin (these 7 bases cover every 64-bit integer)
+// and Pollard-rho (Brent) factorization, both on Montgomery arithmetic.
+namespace Factorizer
+{
+    const uint32_t SMALL_PRIMES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61};
+
+    bool isPrime(uint64_t n)
     {
-        cout<<num<<" is not a prime number."<<endl;
-        cout<<"Factors of " <<num<<" are : ";
-        for (int i = 1; i <= num; i++) // divisibility up to n
-        { 
-            if (num % i == 0) 
+        if (n < 2) return false;
+        for (uint32_t p : SMALL_PRIMES)
+        {
+            if (n % p == 0) return n == p;
+        }
+        if (n < 61 * 61) return true;
+        Montgomery mont(n);
+        uint64_t d = n - 1;
+        int s = __builtin_ctzll(d);
+        d >>= s;
+        uint64_t one = mont.to(1), minusOne = mont.to(n - 1);
+        for (uint64_t a : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL})
+        {
+            if (a % n == 0) continue;
+            uint64_t x = mont.pow(mont.to(a), d);
+            if (x == one || x == minusOne) continue;
+            bool composite = true;
+            for (int r = 1; r < s && composite; r++)
             {
-                cout<<i<< " ";
+                x = mont.mul(x, x);
+                if (x == minusOne) composite = false;
             }
+            if (composite) return false;
         }
-        cout<<endl;
+        return true;
     }
-    else if(flag==1)
+
+    // Smallest prime greater than n, or 0 if it does not fit in 64 bits
+    uint64_t nextPrime(uint64_t n)
     {
-        cout<<num <<" is a prime number."<<endl;
-        int next = num+1;
-        while (true) 
+        if (n < 2) return 2;
+        if (n >= 18446744073709551557ULL) return 0;
+        uint64_t next = n + 1 + (n % 2);  // first odd candidate above n
+        if (n == 2) next = 3;
+        while (!isPrime(next)) next += 2;
+        return next;
+    }
+
+    // Returns a non-trivial factor of an odd composite n
+    uint64_t rho(uint64_t n)
+    {
+        Montgomery mont(n);
+        for (uint64_t c = 1; ; c++)
         {
-            flag =1;
-            for (int i = 2; i < next; i++) 
-            { 
-                if (next % i == 0) 
+            uint64_t cm = mont.to(c);
+            uint64_t y = mont.to(2), x = y, ys = y, q = mont.to(1), g = 1;
+            const uint64_t m = 128;  // gcd is taken once per batch of m steps
+            for (uint64_t r = 1; g == 1; r <<= 1)
+            {
+                x = y;
+                for (uint64_t i = 0; i < r; i++) y = mont.add(mont.mul(y, y), cm);
+                for (uint64_t k = 0; k < r && g == 1; k += m)
                 {
-                    flag= 0; //not prime
-                    break; 
+                    ys = y;
+                    for (uint64_t i = 0; i < m && i < r - k; i++)
+                    {
+                        y = mont.add(mont.mul(y, y), cm);
+                        q = mont.mul(q, x > y ? x - y : y - x);
+                    }
+                    g = gcd(q, n);
                 }
             }
-            if (flag==1){
-                cout<<"The next prime number greater than "<<num<<" is "<<next<<endl;
-                break;
+            if (g == n)  // batch overshot, replay it one step at a time
+            {
+                do
+                {
+                    ys = mont.add(mont.mul(ys, ys), cm);
+                    g = gcd(x > ys ? x - ys : ys - x, n);
+                } while (g == 1);
             }
-            else{
-                next++;
+            if (g != n) return g;
+        }
+    }
+
+    void collect(uint64_t n, vector<uint64_t>& primes)
+    {
+        if (n == 1) return;
+        if (isPrime(n))
+        {
+            primes.push_back(n);
+            return;
+        }
+        uint64_t d = rho(n);
+        collect(d, primes);
+        collect(n / d, primes);
+    }
+
+    // Prime factorization as sorted (prime, exponent) pairs
+    vector<pair<uint64_t, int>> factorize(uint64_t n)
+    {
+        vector<uint64_t> primes;
+        for (uint32_t p : SMALL_PRIMES)
+        {
+            while (n % p == 0)
+            {
+                primes.push_back(p);
+                n /= p;
             }
         }
+        collect(n, primes);
+        sort(primes.begin(), primes.end());
+        vector<pair<uint64_t, int>> factors;
+        for (uint64_t p : primes)
+        {
+            if (!factors.empty() && factors.back().first == p) factors.back().second++;
+            else factors.push_back({p, 1});
+        }
+        return factors;
+    }
+
+    // All divisors of n in increasing order, built from the factorization
+    vector<uint64_t> divisors(uint64_t n)
+    {
+        vector<uint64_t> result = {1};
+        for (auto& f : factorize(n))
+        {
+            size_t count = result.size();
+            uint64_t power = 1;
+            for (int e = 0; e < f.second; e++)
+            {
+                power *= f.first;
+                for (size_t i = 0; i < count; i++) result.push_back(result[i] * power);
+            }
+        }
+        sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+// Compile-time tables for n < 2^20: one bit per odd number, plus for every
+// 64-bit word the first prime after it, so lookups need no loop at runtime
+const uint32_t TABLE_LIMIT = 1 << 20;
+
+struct SmallPrimeTable
+{
+    uint64_t bits[TABLE_LIMIT / 128];       // bit i of word w <=> 128w + 2i + 1 is prime
+    uint32_t nextAfter[TABLE_LIMIT / 128];  // smallest prime >= 128(w + 1)
+};
+
+constexpr SmallPrimeTable makeSmallPrimeTable()
+{
+    SmallPrimeTable t{};
+    for (uint32_t w = 0; w < TABLE_LIMIT / 128; w++) t.bits[w] = ~0ULL;
+    t.bits[0] &= ~1ULL;  // 1 is not prime
+    for (uint32_t p = 3; p * p < TABLE_LIMIT; p += 2)
+    {
+        if (!((t.bits[p >> 7] >> ((p >> 1) & 63)) & 1)) continue;
+        for (uint32_t j = p * p; j < TABLE_LIMIT; j += 2 * p)
+            t.bits[j >> 7] &= ~(1ULL << ((j >> 1) & 63));
+    }
+    uint32_t next = 1048583;  // first prime above 2^20
+    for (uint32_t w = TABLE_LIMIT / 128; w-- > 0; )
+    {
+        t.nextAfter[w] = next;
+        if (t.bits[w]) next = 128 * w + 2 * __builtin_ctzll(t.bits[w]) + 1;
+    }
+    return t;
+}
+
+constexpr SmallPrimeTable SMALL_PRIMES = makeSmallPrimeTable();
+
+// Primality from the table for n < 2^20, Miller-Rabin above
+inline bool isPrimeFast(uint64_t n)
+{
+    if (n < TABLE_LIMIT) return n == 2 || ((n & 1) && ((SMALL_PRIMES.bits[n >> 7] >> ((n >> 1) & 63)) & 1));
+    return Factorizer::isPrime(n);
+}
+
+// Next prime from the table for n < 2^20, Miller-Rabin above
+inline uint64_t nextPrimeFast(uint64_t n)
+{
+    if (n < 2) return 2;
+    uint64_t m = (n + 1) | 1;  // first odd number above n
+    if (m >= TABLE_LIMIT) return Factorizer::nextPrime(n);
+    uint64_t word = SMALL_PRIMES.bits[m >> 7] & (~0ULL << ((m >> 1) & 63));
+    return word ? (m & ~127ULL) + 2 * __builtin_ctzll(word) + 1 : SMALL_PRIMES.nextAfter[m >> 7];
+}
+
+// Keeps recently used sieve segments warm for the streaming mode. A segment
+// is only sieved once it has been asked about a few times; until then (and
+// for numbers too big to sieve cheaply) Miller-Rabin answers directly.
+class WarmPrimeCache
+{
+public:
+    static const int SLOTS = 16;
+    static const int HOT_AFTER = 4;  // queries into one segment before it is sieved
+
+    WarmPrimeCache() : clock(0)
+    {
+        uint64_t limit = sieve.cachedLimit();
+        sieveLimit = limit * limit;  // segments below this never need the inner pass
+        for (Slot& slot : slots)
+        {
+            slot.base = ~0ULL;
+            slot.lastUse = 0;
+            slot.bits.resize(SegmentedSieve::SEGMENT_BITS / 64);
+        }
+    }
+
+    bool isPrime(uint64_t n)
+    {
+        if (n < TABLE_LIMIT) return isPrimeFast(n);
+        if (n % 2 == 0) return false;
+        Slot* slot = segmentFor(n);
+        if (!slot) return Factorizer::isPrime(n);
+        return SegmentedSieve::testBit(slot->bits, (n - slot->base) >> 1);
+    }
+
+    uint64_t nextPrime(uint64_t n)
+    {
+        if (n < TABLE_LIMIT - 1) return nextPrimeFast(n);
+        if (n >= 18446744073709551557ULL) return 0;
+        Slot* slot = segmentFor(n + 1);
+        if (slot)
+        {
+            uint64_t index = (n + 1 - slot->base) >> 1;
+            for (uint64_t w = index / 64; w < slot->bits.size(); w++)
+            {
+                uint64_t word = slot->bits[w];
+                if (w == index / 64) word &= ~0ULL << (index % 64);
+                if (word) return slot->base + 2 * (w * 64 + __builtin_ctzll(word)) + 1;
+            }
+        }
+        return Factorizer::nextPrime(n);
+    }
+
+private:
+    struct Slot
+    {
+        uint64_t base;
+        uint64_t lastUse;
+        vector<uint64_t> bits;
+    };
+    SegmentedSieve sieve;
+    Slot slots[SLOTS];
+    unordered_map<uint64_t, int> misses;  // query counts of segments that are not warm yet
+    uint64_t sieveLimit;
+    uint64_t clock;
+
+    // Warm segment holding n, sieving it first if it has become hot
+    Slot* segmentFor(uint64_t n)
+    {
+        uint64_t base = n - n % SegmentedSieve::SEGMENT_SPAN;
+        Slot* oldest = &slots[0];
+        for (Slot& slot : slots)
+        {
+            if (slot.base == base)
+            {
+                slot.lastUse = ++clock;
+                return &slot;
+            }
+            if (slot.lastUse < oldest->lastUse) oldest = &slot;
+        }
+        if (n >= sieveLimit) return nullptr;
+        if (misses.size() > 4096) misses.clear();
+        if (++misses[base] < HOT_AFTER) return nullptr;
+        misses.erase(base);
+        sieve.sieveSegment(base, oldest->bits);
+        oldest->base = base;
+        oldest->lastUse = ++clock;
+        return oldest;
+    }
+};
+
+// Answers one query per line: "prime N", "factors N" or "next N" (a bare N
+// means "prime N"). Output is buffered and the rate goes to stderr at exit.
+int runStream(const char* path)
+{
+    int fd = path ? open(path, O_RDONLY) : 0;
+    if (fd < 0)
+    {
+        cerr<<"Cannot open "<<path<<endl;
+        return 1;
+    }
+    FastReader in(fd, nullptr, 1 << 20);
+    FastWriter out;
+
+    WarmPrimeCache cache;
+    uint64_t queries = 0;
+    auto start = chrono::steady_clock::now();
+    string line;
+    while (in.readLine(line))
+    {
+        const char* p = line.c_str();
+        const char* end = p + line.size();
+        while (*p == ' ' || *p == '\t') p++;
+        if (p == end) continue;
+        string op = "prime";
+        if (isalpha((unsigned char)*p))
+        {
+            const char* word = p;
+            while (isalpha((unsigned char)*p)) p++;
+            op.assign(word, p);
+            while (*p == ' ' || *p == '\t') p++;
+        }
+        uint64_t n;
+        auto parsed = from_chars(p, end, n);
+        queries++;
+        out<<(parsed.ec == errc() ? n : 0);
+        if (parsed.ec != errc() || n < 2)
+            out<<" invalid";
+        else if (op == "prime")
+            out<<(cache.isPrime(n) ? " prime" : " composite");
+        else if (op == "next")
+            out<<" next "<<cache.nextPrime(n);
+        else if (op == "factors")
+        {
+            out<<":";
+            for (uint64_t d : Factorizer::divisors(n))
+            {
+                out<<' '<<d;
+            }
+        }
+        else
+            out<<" invalid";
+        out<<'\n';
+    }
+    out.flush();
+    if (fd != 0) close(fd);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr<<queries<<" queries in "<<seconds<<" s ("<<(seconds > 0 ? queries / seconds : 0)<<" queries/s)"<<endl;
+    return 0;
+}
+
+// Ranges are cut into chunks of 64 whole segments for the thread pool
+const uint64_t CHUNK_SPAN = SegmentedSieve::SEGMENT_SPAN * 64;
+
+// One sieve per worker thread, built the first time that thread needs it
+SegmentedSieve& threadSieve()
+{
+    thread_local SegmentedSieve sieve;
+    return sieve;
+}
+
+uint64_t parallelCountPrimes(uint64_t lo, uint64_t hi, WorkStealingPool& pool)
+{
+    if (lo > hi) return 0;
+    atomic<uint64_t> total(0);
+    for (uint64_t k = lo / CHUNK_SPAN; k <= hi / CHUNK_SPAN; k++)
+    {
+        uint64_t a = max(lo, k * CHUNK_SPAN), b = min(hi, k * CHUNK_SPAN + CHUNK_SPAN - 1);
+        pool.submit([a, b, &total] { total += threadSieve().countPrimes(a, b); });
+    }
+    pool.wait();
+    return total;
+}
+
+// Calls emit(primes) for every chunk of [lo, hi] in increasing order, while
+// the chunks after it are still being sieved. At most 4 chunks per thread
+// are in flight, so memory does not grow with the range.
+template <class F>
+void parallelForEachPrimeChunk(uint64_t lo, uint64_t hi, WorkStealingPool& pool, F emit)
+{
+    if (lo > hi) return;
+    uint64_t first = lo / CHUNK_SPAN, last = hi / CHUNK_SPAN;
+    size_t window = 4 * pool.size();
+    vector<vector<uint64_t>> results(window);
+    vector<char> ready(window, 0);
+    mutex m;
+    condition_variable done;
+    auto launch = [&](uint64_t k)
+    {
+        size_t slot = (k - first) % window;
+        uint64_t a = max(lo, k * CHUNK_SPAN), b = min(hi, k * CHUNK_SPAN + CHUNK_SPAN - 1);
+        pool.submit([&, slot, a, b]
+        {
+            vector<uint64_t> primes;
+            threadSieve().forEachPrime(a, b, [&](uint64_t p) { primes.push_back(p); });
+            lock_guard<mutex> lock(m);
+            results[slot].swap(primes);
+            ready[slot] = 1;
+            done.notify_all();
+        });
+    };
+    uint64_t nextLaunch = first;
+    while (nextLaunch <= last && nextLaunch - first < window) launch(nextLaunch++);
+    for (uint64_t k = first; k <= last; k++)
+    {
+        size_t slot = (k - first) % window;
+        vector<uint64_t> primes;
+        {
+            unique_lock<mutex> lock(m);
+            done.wait(lock, [&] { return ready[slot] != 0; });
+            primes.swap(results[slot]);
+            ready[slot] = 0;
+        }
+        emit(primes);
+        if (nextLaunch <= last) launch(nextLaunch++);
+    }
+    pool.wait();
+}
+
+// --count lo hi [threads] prints how many primes lie in [lo, hi];
+// --list lo hi [threads] prints them in increasing order
+int runRange(bool list, int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        cerr<<"Usage: "<<argv[0]<<" "<<argv[1]<<" lo hi [threads]"<<endl;
+        return 1;
+    }
+    uint64_t lo = strtoull(argv[2], nullptr, 10), hi = strtoull(argv[3], nullptr, 10);
+    WorkStealingPool pool(argc > 4 ? atoi(argv[4]) : 0);
+    auto start = chrono::steady_clock::now();
+    uint64_t count = 0;
+    if (list)
+    {
+        FastWriter out;
+        parallelForEachPrimeChunk(lo, hi, pool, [&](const vector<uint64_t>& primes)
+        {
+            for (uint64_t p : primes)
+            {
+                out<<p<<'\n';
+            }
+            count += primes.size();
+        });
+    }
+    else
+    {
+        count = parallelCountPrimes(lo, hi, pool);
+        cout<<"Primes in ["<<lo<<", "<<hi<<"]: "<<count<<endl;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr<<count<<" primes in "<<seconds<<" s on "<<pool.size()<<" threads"<<endl;
+    return 0;
+}
+
+// The primality loops this program used before the table and engines
+bool loopIsPrime(uint64_t num)
+{
+    for (uint64_t i = 2; i < num / 2; i++)
+    {
+        if (num % i == 0) return false;
+    }
+    return true;
+}
+
+uint64_t loopNextPrime(uint64_t num)
+{
+    for (uint64_t next = num + 1; ; next++)
+    {
+        uint64_t i = 2;
+        while (i < next && next % i != 0) i++;
+        if (i == next) return next;
+    }
+}
+
+// --bench [queries] times table lookups against the old loops on random n < 2^20
+int runBench(int argc, char* argv[])
+{
+    size_t queries = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000;
+    vector<uint64_t> inputs(queries);
+    uint64_t seed = 88172645463325252ULL;
+    for (uint64_t& n : inputs)
+    {
+        seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+        n = 2 + seed % (TABLE_LIMIT - 2);
+    }
+    auto time = [&](const char* label, int repeat, auto query)
+    {
+        uint64_t checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++)
+        {
+            for (uint64_t n : inputs) checksum += query(n);
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ((double)repeat * queries);
+        cout<<label<<": "<<ns<<" ns/query (checksum "<<checksum<<")"<<endl;
+        return ns;
+    };
+    double loopPrime = time("is-prime, loop ", 1, loopIsPrime);
+    double tablePrime = time("is-prime, table", 10000, isPrimeFast);
+    double loopNext = time("next-prime, loop ", 1, loopNextPrime);
+    double tableNext = time("next-prime, table", 10000, nextPrimeFast);
+    cout<<"Speedup: is-prime x"<<loopPrime / tablePrime<<", next-prime x"<<loopNext / tableNext<<endl;
+    return 0;
+}
+
+// --check sieves a few windows where the 64-bit arithmetic is most
+// likely to go wrong, the top of the range among them, and compares every
+// odd number with Miller-Rabin; exits non-zero on any difference
+int runCheck()
+{
+    const uint64_t top = 18446744073709551615ULL, largestPrime = 18446744073709551557ULL;
+    const uint64_t windows[][2] = {{0, 100000}, {(1ULL << 32) - 3000, (1ULL << 32) + 3000}, {top - 2000, top}};
+    SegmentedSieve sieve;
+    size_t errors = 0;
+    uint64_t expectedLast = 0;
+    for (const auto& window : windows)
+    {
+        vector<uint64_t> listed, expected;
+        sieve.forEachPrime(window[0], window[1], [&](uint64_t p) { listed.push_back(p); });
+        for (uint64_t n = window[0]; ; n++)
+        {
+            if (Factorizer::isPrime(n)) expected.push_back(n);
+            if (n == window[1]) break;
+        }
+        expectedLast = expected.back();
+        if (listed != expected || sieve.countPrimes(window[0], window[1]) != expected.size())
+        {
+            cerr<<"Sieve and Miller-Rabin differ in ["<<window[0]<<", "<<window[1]<<"]"<<endl;
+            errors++;
+        }
+    }
+    // the last window ends with the largest prime (18446744073709551577,
+    // which the sieve once let through, is composite)
+    if (expectedLast != largestPrime || sieve.nextPrime(largestPrime) != 0)
+    {
+        cerr<<"Wrong answer near the largest 64-bit prime"<<endl;
+        errors++;
+    }
+    cout<<(errors ? "FAILED" : "ok")<<endl;
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // --stream [file] answers newline separated queries instead of one number
+    if (argc > 1 && string(argv[1]) == "--stream")
+        return runStream(argc > 2 ? argv[2] : nullptr);
+    if (argc > 1 && (string(argv[1]) == "--count" || string(argv[1]) == "--list"))
+        return runRange(string(argv[1]) == "--list", argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench")
+        return runBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--check")
+        return runCheck();
+
+    FastWriter out;
+    FastReader in(0, &out);
+    uint64_t num;
+    out<<"Enter a positive integer: ";
+    if (!in.readInt(num) || num <= 1) //checking if -ve
+    {
+        out<<"Wrong Input !\n";
+        return 0;
+    }
+    if (!isPrimeFast(num))
+    {
+        out<<num<<" is not a prime number.\n";
+        out<<"Factors of " <<num<<" are : ";
+        for (uint64_t d : Factorizer::divisors(num))
+        {
+            out<<d<< " ";
+        }
+        out<<'\n';
     }
     else
     {
-        cout<<"ERROR"<<endl;
+        out<<num <<" is a prime number.\n";
+        uint64_t next = nextPrimeFast(num);
+        if (next == 0)
+            out<<"There is no prime number greater than "<<num<<" below 2^64\n";
+        else
+            out<<"The next prime number greater than "<<num<<" is "<<next<<'\n';
     }
     return 0;
-}
\ No newline at end of file
+}
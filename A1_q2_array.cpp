@@ -1,76 +1,738 @@
 #include <iostream>
 #include <climits>
-#include <algorithm> 
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <charconv>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "A1_fast_io.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define A1_X86_SIMD 1
+#endif
 using namespace std;
-int main() 
+
+// Largest, second largest, smallest and second smallest distinct values of
+// everything added so far, found in one pass. A missing second value is
+// left at INT_MIN / INT_MAX. Partial results over separate blocks can be
+// combined with merge().
+struct ArrayStats
 {
-    int size;
-    cout<<"Enter the size of the array: ";
-    cin>>size;
-    int arr[size],arr1[size];  //size determined at runtime
-    cout<<"Enter "<<size<<" elements: ";
-    for (int i = 0; i < size; i++) 
+    int largest = INT_MIN, secondLargest = INT_MIN;
+    int smallest = INT_MAX, secondSmallest = INT_MAX;
+    long long count = 0;
+
+    // true when the input holds at least two distinct values
+    bool hasTwoDistinct() const { return count > 0 && smallest != largest; }
+
+    void addMax(int v)
     {
-        cin>>arr[i];
+        if (v > largest)
+        {
+            secondLargest = largest;
+            largest = v;
+        }
+        else if (v < largest && v > secondLargest)
+        {
+            secondLargest = v;
+        }
     }
-    cout << "Reversed array: ";
-    for (int i = size - 1; i >= 0; i--) 
+
+    void addMin(int v)
     {
-        cout<<arr[i]<<" ";
+        if (v < smallest)
+        {
+            secondSmallest = smallest;
+            smallest = v;
+        }
+        else if (v > smallest && v < secondSmallest)
+        {
+            secondSmallest = v;
+        }
     }
-    cout<<endl;
-    if (size < 2) {
-        cout<<"Array size is too small to find second largest or second smallest element." << endl;
-        return 0;
+
+    void addScalar(const int* a, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            addMax(a[i]);
+            addMin(a[i]);
+        }
+        count += n;
     }
-    int largest = arr[0], secondLargest = INT_MIN;
-    int smallest = arr[0], secondSmallest = INT_MAX;
-    for (int i = 0; i < size; i++) //copying to another array to sort
+
+    void merge(const ArrayStats& other)
     {
-        arr1[i]=arr[i];
+        addMax(other.largest);
+        addMax(other.secondLargest);
+        addMin(other.smallest);
+        addMin(other.secondSmallest);
+        count += other.count;
     }
-    // Finding unique elements count 
-    int uniqueCount = 0;
-    for (int i = 1; i < size; ++i) {
-        sort(arr1, arr1 + size);
-        if (arr1[i] != arr1[i - 1]) {
-            uniqueCount++;
+
+    // Picks the widest SIMD path the CPU supports at runtime
+    void add(const int* a, size_t n)
+    {
+#ifdef A1_X86_SIMD
+        if (__builtin_cpu_supports("avx2")) return addAvx2(a, n);
+        if (__builtin_cpu_supports("sse4.1")) return addSse41(a, n);
+#endif
+        addScalar(a, n);
+    }
+
+#ifdef A1_X86_SIMD
+    // Each lane keeps its own top-2 / bottom-2; lanes are folded in at the end.
+    // Per lane: v > m1 shifts m1 down to m2, m1 > v > m2 replaces m2.
+    __attribute__((target("avx2"))) void addAvx2(const int* a, size_t n)
+    {
+        __m256i m1 = _mm256_set1_epi32(INT_MIN), m2 = m1;
+        __m256i n1 = _mm256_set1_epi32(INT_MAX), n2 = n1;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i above = _mm256_cmpgt_epi32(v, m1), below = _mm256_cmpgt_epi32(m1, v);
+            m2 = _mm256_blendv_epi8(_mm256_blendv_epi8(m2, _mm256_max_epi32(m2, v), below), m1, above);
+            m1 = _mm256_max_epi32(m1, v);
+            below = _mm256_cmpgt_epi32(n1, v), above = _mm256_cmpgt_epi32(v, n1);
+            n2 = _mm256_blendv_epi8(_mm256_blendv_epi8(n2, _mm256_min_epi32(n2, v), above), n1, below);
+            n1 = _mm256_min_epi32(n1, v);
         }
+        int lanes[4][8];
+        _mm256_storeu_si256((__m256i*)lanes[0], m1);
+        _mm256_storeu_si256((__m256i*)lanes[1], m2);
+        _mm256_storeu_si256((__m256i*)lanes[2], n1);
+        _mm256_storeu_si256((__m256i*)lanes[3], n2);
+        foldLanes(lanes[0], lanes[1], lanes[2], lanes[3], 8, i);
+        addScalar(a + i, n - i);
     }
-    if (uniqueCount < 2) {
-        cout << "Not enough unique elements to determine second largest and second smallest." << endl;
+
+    __attribute__((target("sse4.1"))) void addSse41(const int* a, size_t n)
+    {
+        __m128i m1 = _mm_set1_epi32(INT_MIN), m2 = m1;
+        __m128i n1 = _mm_set1_epi32(INT_MAX), n2 = n1;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(a + i));
+            __m128i above = _mm_cmpgt_epi32(v, m1), below = _mm_cmpgt_epi32(m1, v);
+            m2 = _mm_blendv_epi8(_mm_blendv_epi8(m2, _mm_max_epi32(m2, v), below), m1, above);
+            m1 = _mm_max_epi32(m1, v);
+            below = _mm_cmpgt_epi32(n1, v), above = _mm_cmpgt_epi32(v, n1);
+            n2 = _mm_blendv_epi8(_mm_blendv_epi8(n2, _mm_min_epi32(n2, v), above), n1, below);
+            n1 = _mm_min_epi32(n1, v);
+        }
+        int lanes[4][4];
+        _mm_storeu_si128((__m128i*)lanes[0], m1);
+        _mm_storeu_si128((__m128i*)lanes[1], m2);
+        _mm_storeu_si128((__m128i*)lanes[2], n1);
+        _mm_storeu_si128((__m128i*)lanes[3], n2);
+        foldLanes(lanes[0], lanes[1], lanes[2], lanes[3], 4, i);
+        addScalar(a + i, n - i);
     }
-    else{
-    for (int i = 1; i < size; i++) 
+
+    void foldLanes(const int* m1, const int* m2, const int* n1, const int* n2, int width, size_t consumed)
     {
-        //SECOND LARGEST
-        if (arr[i] > largest) 
+        for (int l = 0; l < width; l++)
         {
-            secondLargest = largest;
-            largest = arr[i];
-        } 
-        else if (arr[i] > secondLargest && arr[i] != largest) 
+            addMax(m1[l]);
+            addMax(m2[l]);
+            addMin(n1[l]);
+            addMin(n2[l]);
+        }
+        count += consumed;
+    }
+#endif
+};
+
+// k largest and k smallest distinct values. Each side is a heap of at most
+// k values whose root is the current cut-off (a min-heap for the largest,
+// a max-heap for the smallest), so most values are rejected by one compare.
+// merge() is associative, so partial results can be combined in any grouping.
+// A hash set per side holds the values in its heap, so a repeated value is
+// turned away in O(1) even while the heap is not full yet (which is the
+// whole input when it has fewer than k distinct values).
+struct TopK
+{
+    size_t k;
+    vector<int> largest, smallest;
+    unordered_set<int> inLargest, inSmallest;
+
+    explicit TopK(size_t keep) : k(keep)
+    {
+        largest.reserve(k + 1);
+        smallest.reserve(k + 1);
+    }
+
+    template <class Better>
+    void offer(vector<int>& heap, unordered_set<int>& kept, int v, Better better)
+    {
+        // heap is ordered so that its front is the worst value kept
+        if (heap.size() == k && !better(v, heap.front())) return;
+        if (!kept.insert(v).second) return;
+        if (heap.size() == k)
         {
-            secondLargest = arr[i];
+            pop_heap(heap.begin(), heap.end(), better);
+            kept.erase(heap.back());
+            heap.pop_back();
         }
-        //SECOND SMALLEST
-        if (arr[i] < smallest) 
+        heap.push_back(v);
+        push_heap(heap.begin(), heap.end(), better);
+    }
+
+    void add(int v)
+    {
+        if (k == 0) return;
+        offer(largest, inLargest, v, greater<int>());
+        offer(smallest, inSmallest, v, less<int>());
+    }
+
+    void add(const int* a, size_t n)
+    {
+        if (k == 0) return;
+        size_t i = 0;
+        for (; i < n && (largest.size() < k || smallest.size() < k); i++) add(a[i]);
+        if (i == n) return;
+        // both heaps are full: keep the cut-offs in registers
+        int topCut = largest.front(), bottomCut = smallest.front();
+        for (; i < n; i++)
         {
-            secondSmallest = smallest;
-            smallest = arr[i];
-        } 
-        else if (arr[i] < secondSmallest && arr[i] != smallest) 
+            int v = a[i];
+            if (v > topCut)
+            {
+                offer(largest, inLargest, v, greater<int>());
+                topCut = largest.front();
+            }
+            if (v < bottomCut)
+            {
+                offer(smallest, inSmallest, v, less<int>());
+                bottomCut = smallest.front();
+            }
+        }
+    }
+
+    void merge(const TopK& other)
+    {
+        for (int v : other.largest) offer(largest, inLargest, v, greater<int>());
+        for (int v : other.smallest) offer(smallest, inSmallest, v, less<int>());
+    }
+
+    // largest first
+    vector<int> top() const
+    {
+        vector<int> result = largest;
+        sort(result.begin(), result.end(), greater<int>());
+        return result;
+    }
+
+    // smallest first
+    vector<int> bottom() const
+    {
+        vector<int> result = smallest;
+        sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+// Top-k / bottom-k of a[0..n) on the given number of threads: every thread
+// reduces one contiguous slice into its own TopK, the partials are merged
+TopK parallelTopK(const int* a, size_t n, size_t k, unsigned threads)
+{
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = (unsigned)max<size_t>(1, min<size_t>(threads, n / 4096 + 1));
+    vector<TopK> partial(threads, TopK(k));
+    vector<thread> workers;
+    size_t slice = n / threads;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        size_t from = t * slice, to = t + 1 == threads ? n : from + slice;
+        workers.emplace_back([&, t, from, to] { partial[t].add(a + from, to - from); });
+    }
+    for (thread& w : workers) w.join();
+    for (unsigned t = 1; t < threads; t++) partial[0].merge(partial[t]);
+    return partial[0];
+}
+
+// HyperLogLog distinct-count estimator: 2^p one-byte registers, each holding
+// the longest run of leading zeros seen among the hashes routed to it.
+// Sketches with the same precision merge by taking register-wise maxima.
+class HyperLogLog
+{
+public:
+    static const int MIN_PRECISION = 4, MAX_PRECISION = 18;
+
+    // standard error of a sketch with precision p
+    static double errorFor(int p) { return 1.04 / sqrt((double)((size_t)1 << p)); }
+
+    // smallest precision whose standard error meets errorBound; bounds
+    // below errorFor(MAX_PRECISION) cannot be met and get MAX_PRECISION
+    static int precisionFor(double errorBound)
+    {
+        int p = MIN_PRECISION;
+        while (p < MAX_PRECISION && errorFor(p) > errorBound) p++;
+        return p;
+    }
+
+    explicit HyperLogLog(int precision = 14) : p(precision), registers((size_t)1 << precision, 0) {}
+
+    int precision() const { return p; }
+    double standardError() const { return errorFor(p); }
+
+    void add(int v)
+    {
+        uint64_t h = mix((uint32_t)v);
+        uint64_t index = h >> (64 - p);
+        uint8_t rank = (uint8_t)(__builtin_clzll((h << p) | (1ULL << (p - 1))) + 1);
+        if (rank > registers[index]) registers[index] = rank;
+    }
+
+    void add(const int* a, size_t n)
+    {
+        for (size_t i = 0; i < n; i++) add(a[i]);
+    }
+
+    double estimate() const
+    {
+        double m = (double)registers.size(), sum = 0;
+        size_t zeros = 0;
+        for (uint8_t r : registers)
+        {
+            sum += ldexp(1.0, -r);
+            zeros += r == 0;
+        }
+        double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros > 0) return m * log(m / zeros);  // linear counting for small sets
+        return raw;
+    }
+
+    bool merge(const HyperLogLog& other)
+    {
+        if (other.p != p) return false;
+        for (size_t i = 0; i < registers.size(); i++)
+            registers[i] = max(registers[i], other.registers[i]);
+        return true;
+    }
+
+    // Sketch file: "HLL1", one precision byte, then the 2^p registers
+    bool save(const char* path) const
+    {
+        FILE* f = fopen(path, "wb");
+        if (!f) return false;
+        uint8_t header[5] = {'H', 'L', 'L', '1', (uint8_t)p};
+        bool ok = fwrite(header, 1, 5, f) == 5 && fwrite(registers.data(), 1, registers.size(), f) == registers.size();
+        return fclose(f) == 0 && ok;
+    }
+
+    static bool load(const char* path, HyperLogLog& out)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+        uint8_t header[5];
+        bool ok = fread(header, 1, 5, f) == 5 && memcmp(header, "HLL1", 4) == 0 && header[4] >= MIN_PRECISION && header[4] <= MAX_PRECISION;
+        if (ok)
+        {
+            out = HyperLogLog(header[4]);
+            ok = fread(out.registers.data(), 1, out.registers.size(), f) == out.registers.size();
+        }
+        fclose(f);
+        return ok;
+    }
+
+private:
+    int p;
+    vector<uint8_t> registers;
+
+    static uint64_t mix(uint64_t x)  // splitmix64 finalizer
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+};
+
+// --bench [millions] compares the SIMD kernel with the scalar loop
+int runBench(int argc, char* argv[])
+{
+    size_t n = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 100) * 1000000;
+    vector<int> data(n);
+    uint32_t seed = 2463534242u;
+    for (int& x : data)
+    {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        x = (int)seed;
+    }
+    auto time = [&](const char* label, void (ArrayStats::*kernel)(const int*, size_t))
+    {
+        ArrayStats stats;
+        auto start = chrono::steady_clock::now();
+        (stats.*kernel)(data.data(), n);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout<<label<<": "<<seconds * 1000<<" ms, "<<n * sizeof(int) / seconds / 1e9<<" GB/s"
+            <<" (2nd largest "<<stats.secondLargest<<", 2nd smallest "<<stats.secondSmallest<<")"<<endl;
+    };
+    time("scalar", &ArrayStats::addScalar);
+    time("simd  ", &ArrayStats::add);
+    return 0;
+}
+
+// Read-only memory map of a whole file; pages are loaded on demand and can
+// be dropped again by the kernel, so files larger than RAM are fine
+class MappedFile
+{
+public:
+    explicit MappedFile(const char* path) : data(nullptr), size(0), valid(false)
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            size = st.st_size;
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            data = p == MAP_FAILED ? nullptr : (const char*)p;
+        }
+        valid = data != nullptr || size == 0;
+        close(fd);
+    }
+    ~MappedFile()
+    {
+        if (data) munmap((void*)data, size);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void advise(int advice) const
+    {
+        if (data) madvise((void*)data, size, advice);
+    }
+
+    const char* data;
+    size_t size;
+    bool valid;
+};
+
+// Calls f(values, count) for consecutive blocks of the file's integers;
+// text is parsed into one fixed-size block that is reused
+template <class F>
+bool forEachBlock(const MappedFile& file, bool binary, F f)
+{
+    if (binary)
+    {
+        f((const int*)file.data, file.size / sizeof(int));
+        return true;
+    }
+    static int block[1 << 16];
+    size_t filled = 0;
+    const char* p = file.data;
+    const char* end = file.data + file.size;
+    while (true)
+    {
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p == end) break;
+        auto parsed = from_chars(p, end, block[filled]);
+        if (parsed.ec != errc() || (parsed.ptr < end && !isspace((unsigned char)*parsed.ptr)))
+        {
+            cerr<<"Invalid integer at byte "<<p - file.data<<endl;
+            return false;
+        }
+        p = parsed.ptr;
+        if (++filled == sizeof(block) / sizeof(int))
         {
-            secondSmallest = arr[i];
+            f((const int*)block, filled);
+            filled = 0;
         }
-    }   
-    //incase ALL THE ELEMENTS ARE SAME
-    if (secondLargest == INT_MIN || secondSmallest == INT_MAX)
-        cout << "No distinct second largest or second smallest element exists." << endl;
-    else 
+    }
+    f((const int*)block, filled);
+    return true;
+}
+
+// Writes the integers of the file last to first, walking the mapping backwards
+void streamReverse(const MappedFile& file, bool binary, FastWriter& out)
+{
+    if (binary)
+    {
+        const int* values = (const int*)file.data;
+        for (size_t i = file.size / sizeof(int); i-- > 0; )
+        {
+            out<<values[i]<<' ';
+        }
+        return;
+    }
+    const char* begin = file.data;
+    const char* p = file.data + file.size;
+    while (true)
+    {
+        while (p > begin && isspace((unsigned char)p[-1])) p--;
+        if (p == begin) break;
+        const char* tokenEnd = p;
+        while (p > begin && !isspace((unsigned char)p[-1])) p--;
+        out.write(p, tokenEnd - p);  // already validated by the stats pass
+        out<<' ';
+    }
+}
+
+void reportStats(const ArrayStats& stats, FastWriter& out)
+{
+    if (stats.count < 2)
+        out<<"Array size is too small to find second largest or second smallest element.\n";
+    else if (!stats.hasTwoDistinct())
+        out<<"Not enough unique elements to determine second largest and second smallest.\n";
+    else
     {
-        cout << "Second largest: " << secondLargest << endl;
-        cout << "Second smallest: " << secondSmallest << endl;
-    }}
+        out<<"Second largest: "<<stats.secondLargest<<'\n';
+        out<<"Second smallest: "<<stats.secondSmallest<<'\n';
+    }
+}
+
+// --stream file [--binary] processes text (whitespace separated) or raw
+// native int32 files of any size in bounded memory via mmap
+int runStream(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        cerr<<"Usage: "<<argv[0]<<" --stream file [--binary]"<<endl;
+        return 1;
+    }
+    bool binary = argc > 3 && string(argv[3]) == "--binary";
+    MappedFile file(argv[2]);
+    if (!file.valid || (binary && file.size % sizeof(int) != 0))
+    {
+        cerr<<"Cannot read "<<argv[2]<<(binary ? " as int32 data" : "")<<endl;
+        return 1;
+    }
+    ArrayStats stats;
+    file.advise(MADV_SEQUENTIAL);
+    if (!forEachBlock(file, binary, [&](const int* values, size_t n) { stats.add(values, n); })) return 1;
+    file.advise(MADV_NORMAL);
+
+    FastWriter out;
+    out<<"Reversed array: ";
+    streamReverse(file, binary, out);
+    out<<'\n';
+    reportStats(stats, out);
+    return 0;
+}
+
+// --topk k file [--binary] [threads] prints the k largest and k smallest distinct values
+int runTopK(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        cerr<<"Usage: "<<argv[0]<<" --topk k file [--binary] [threads]"<<endl;
+        return 1;
+    }
+    size_t k = strtoull(argv[2], nullptr, 10);
+    bool binary = argc > 4 && string(argv[4]) == "--binary";
+    unsigned threads = argc > 5 ? atoi(argv[5]) : 0;
+    MappedFile file(argv[3]);
+    if (!file.valid || (binary && file.size % sizeof(int) != 0))
+    {
+        cerr<<"Cannot read "<<argv[3]<<(binary ? " as int32 data" : "")<<endl;
+        return 1;
+    }
+    vector<int> parsed;
+    const int* values = (const int*)file.data;
+    size_t n = file.size / sizeof(int);
+    if (!binary)
+    {
+        // text has to be parsed before it can be sliced between threads
+        if (!forEachBlock(file, false, [&](const int* block, size_t count) { parsed.insert(parsed.end(), block, block + count); }))
+            return 1;
+        values = parsed.data();
+        n = parsed.size();
+    }
+    TopK result = parallelTopK(values, n, k, threads);
+    cout<<"Top "<<k<<":";
+    for (int v : result.top()) cout<<" "<<v;
+    cout<<endl<<"Bottom "<<k<<":";
+    for (int v : result.bottom()) cout<<" "<<v;
+    cout<<endl;
+    return 0;
+}
+
+// --bench-topk [millions] [k] [max threads] reports parallelTopK scaling
+int runTopKBench(int argc, char* argv[])
+{
+    size_t n = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 100) * 1000000;
+    size_t k = argc > 3 ? strtoull(argv[3], nullptr, 10) : 2;
+    unsigned maxThreads = argc > 4 ? atoi(argv[4]) : max(1u, thread::hardware_concurrency());
+    vector<int> data(n);
+    uint32_t seed = 2463534242u;
+    for (int& x : data)
+    {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        x = (int)seed;
+    }
+    double base = 0;
+    for (unsigned t = 1; t <= maxThreads; t++)
+    {
+        auto start = chrono::steady_clock::now();
+        TopK result = parallelTopK(data.data(), n, k, t);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (t == 1) base = seconds;
+        cout<<t<<" threads: "<<seconds * 1000<<" ms, speedup x"<<base / seconds
+            <<" (k-th largest "<<(result.largest.empty() ? 0 : result.largest.front())<<")"<<endl;
+    }
+
+    // Many duplicates and k above the number of distinct values: the heaps
+    // never fill, so every value takes the membership check
+    size_t distinct = 1000, bigK = 10 * distinct;
+    for (int& x : data)
+    {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        x = (int)(seed % distinct);
+    }
+    auto start = chrono::steady_clock::now();
+    TopK result = parallelTopK(data.data(), n, bigK, 1);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    bool complete = result.largest.size() == distinct && result.smallest.size() == distinct;
+    cout<<distinct<<" distinct values, k = "<<bigK<<": "<<seconds * 1000<<" ms"
+        <<(complete ? "" : " (WRONG: values missing)")<<endl;
+    return 0;
+}
+
+// --distinct file [--binary] [--error e] [--sketch out.hll] [--exact]
+// estimates the number of distinct values with a HyperLogLog sketch
+// (kilobytes of memory); --exact also counts them from a sorted copy
+int runDistinct(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        cerr<<"Usage: "<<argv[0]<<" --distinct file [--binary] [--error e] [--sketch out.hll] [--exact]"<<endl;
+        return 1;
+    }
+    bool binary = false, exact = false;
+    double errorBound = 0.01;
+    const char* sketchPath = nullptr;
+    for (int a = 3; a < argc; a++)
+    {
+        string flag = argv[a];
+        if (flag == "--binary") binary = true;
+        else if (flag == "--exact") exact = true;
+        else if (flag == "--error" && a + 1 < argc) errorBound = atof(argv[++a]);
+        else if (flag == "--sketch" && a + 1 < argc) sketchPath = argv[++a];
+    }
+    double bestError = HyperLogLog::errorFor(HyperLogLog::MAX_PRECISION);
+    if (!(errorBound >= bestError))
+    {
+        cerr<<"--error "<<errorBound<<" is below the "<<bestError<<" the largest sketch (p = "
+            <<HyperLogLog::MAX_PRECISION<<") can deliver; use --exact for an exact count"<<endl;
+        return 1;
+    }
+    MappedFile file(argv[2]);
+    if (!file.valid || (binary && file.size % sizeof(int) != 0))
+    {
+        cerr<<"Cannot read "<<argv[2]<<(binary ? " as int32 data" : "")<<endl;
+        return 1;
+    }
+    HyperLogLog sketch(HyperLogLog::precisionFor(errorBound));
+    vector<int> all;
+    file.advise(MADV_SEQUENTIAL);
+    bool ok = forEachBlock(file, binary, [&](const int* values, size_t n)
+    {
+        sketch.add(values, n);
+        if (exact) all.insert(all.end(), values, values + n);
+    });
+    if (!ok) return 1;
+    cout<<"Approximate distinct count: "<<(long long)llround(sketch.estimate())
+        <<" (p = "<<sketch.precision()<<", "<<((size_t)1 << sketch.precision())<<" bytes, std. error "
+        <<sketch.standardError() * 100<<"%)"<<endl;
+    if (exact)
+    {
+        sort(all.begin(), all.end());
+        cout<<"Exact distinct count: "<<unique(all.begin(), all.end()) - all.begin()<<endl;
+    }
+    if (sketchPath && !sketch.save(sketchPath))
+    {
+        cerr<<"Cannot write "<<sketchPath<<endl;
+        return 1;
+    }
+    return 0;
+}
+
+// --merge out.hll in1.hll in2.hll ... combines per-shard sketches
+int runMerge(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        cerr<<"Usage: "<<argv[0]<<" --merge out.hll in1.hll [in2.hll ...]"<<endl;
+        return 1;
+    }
+    HyperLogLog merged;
+    for (int a = 3; a < argc; a++)
+    {
+        HyperLogLog shard;
+        if (!HyperLogLog::load(argv[a], shard))
+        {
+            cerr<<"Cannot read sketch "<<argv[a]<<endl;
+            return 1;
+        }
+        if (a == 3) merged = shard;
+        else if (!merged.merge(shard))
+        {
+            cerr<<"Sketch "<<argv[a]<<" has a different precision"<<endl;
+            return 1;
+        }
+    }
+    cout<<"Approximate distinct count: "<<(long long)llround(merged.estimate())<<endl;
+    if (!merged.save(argv[2]))
+    {
+        cerr<<"Cannot write "<<argv[2]<<endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && string(argv[1]) == "--bench")
+        return runBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--stream")
+        return runStream(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--topk")
+        return runTopK(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-topk")
+        return runTopKBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--distinct")
+        return runDistinct(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--merge")
+        return runMerge(argc, argv);
+
+    FastWriter out;
+    FastReader in(0, &out);
+    int size = 0;
+    out<<"Enter the size of the array: ";
+    in.readInt(size);
+    vector<int> arr(max(size, 0));  //size determined at runtime, kept on the heap
+    out<<"Enter "<<size<<" elements: ";
+    for (int i = 0; i < size; i++)
+    {
+        in.readInt(arr[i]);
+    }
+    out << "Reversed array: ";
+    for (int i = size - 1; i >= 0; i--)
+    {
+        out<<arr[i]<<" ";
+    }
+    out<<'\n';
+    // largest, second largest, smallest, second smallest and the unique check in one pass
+    ArrayStats stats;
+    stats.add(arr.data(), arr.size());
+    reportStats(stats, out);
     return 0;
-}
\ No newline at end of file
+}
@@ -1,51 +1,855 @@
 #include <iostream>
 #include <cctype> // string functions (like tolower , isalpha)
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "A1_fast_io.h"
+#include "A1_thread_pool.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define A1_X86_SIMD 1
+#endif
 using namespace std;
 
-int main() {
-    string str;
-    cout << "Enter a string: ";
-    getline(cin, str);
-
-    // Palindrome Check (ignoring spaces and case)
-    int left = 0, right = str.length() - 1;
-    bool isPalin = true;
-    while (left < right) {
-        if (tolower(str[left]) != tolower(str[right])) 
+// ASCII case folding, the same as tolower in the default "C" locale
+inline unsigned char foldCase(unsigned char c) {
+    return (unsigned char)(c - 'A') < 26 ? c | 0x20 : c;
+}
+
+// True when front[0..n) equals back[0..n) read backwards, ignoring case
+bool isMirrorScalar(const char* front, const char* back, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (foldCase(front[i]) != foldCase(back[n - 1 - i])) return false;
+    }
+    return true;
+}
+
+// Counts letters (case-insensitive) into frequency[26] and replaces vowels
+// with '*' in the same pass. Raw bytes are counted into four interleaved
+// 256-entry tables (so repeated letters do not stall on one counter) and
+// folded into the 26 letters at the end.
+struct LetterCounter {
+    uint64_t table[4][256] = {};
+
+    void addScalar(char* s, size_t n) {
+        static const VowelMap map;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            unsigned char a = s[i], b = s[i + 1], c = s[i + 2], d = s[i + 3];
+            table[0][a]++;
+            table[1][b]++;
+            table[2][c]++;
+            table[3][d]++;
+            s[i] = map.to[a];
+            s[i + 1] = map.to[b];
+            s[i + 2] = map.to[c];
+            s[i + 3] = map.to[d];
+        }
+        for (; i < n; i++) {
+            unsigned char a = s[i];
+            table[0][a]++;
+            s[i] = map.to[a];
+        }
+    }
+
+    // Counting only, the text is left as it is
+    void count(const char* s, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            table[0][(unsigned char)s[i]]++;
+            table[1][(unsigned char)s[i + 1]]++;
+            table[2][(unsigned char)s[i + 2]]++;
+            table[3][(unsigned char)s[i + 3]]++;
+        }
+        for (; i < n; i++) table[0][(unsigned char)s[i]]++;
+    }
+
+    void add(char* s, size_t n) {
+#ifdef A1_X86_SIMD
+        if (__builtin_cpu_supports("avx2")) return addAvx2(s, n);
+#endif
+        addScalar(s, n);
+    }
+
+    void frequencies(uint64_t frequency[26]) const {
+        for (int i = 0; i < 26; i++) {
+            frequency[i] = 0;
+            for (int t = 0; t < 4; t++) frequency[i] += table[t]['a' + i] + table[t]['A' + i];
+        }
+    }
+
+    struct VowelMap {
+        char to[256];
+        VowelMap() {
+            for (int c = 0; c < 256; c++) {
+                char folded = (char)foldCase(c);
+                bool vowel = folded == 'a' || folded == 'e' || folded == 'i' || folded == 'o' || folded == 'u';
+                to[c] = vowel ? '*' : (char)c;
+            }
+        }
+    };
+
+#ifdef A1_X86_SIMD
+    // The 32-byte block is counted while it is in L1, then rewritten with
+    // a vector compare against the five vowels
+    __attribute__((target("avx2"))) void addAvx2(char* s, size_t n) {
+        const __m256i upperA = _mm256_set1_epi8('A' - 1), upperZ = _mm256_set1_epi8('Z' + 1);
+        const __m256i caseBit = _mm256_set1_epi8(0x20), star = _mm256_set1_epi8('*');
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            for (size_t k = 0; k < 32; k += 4) {
+                table[0][(unsigned char)s[i + k]]++;
+                table[1][(unsigned char)s[i + k + 1]]++;
+                table[2][(unsigned char)s[i + k + 2]]++;
+                table[3][(unsigned char)s[i + k + 3]]++;
+            }
+            __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+            __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, upperA), _mm256_cmpgt_epi8(upperZ, v));
+            __m256i folded = _mm256_or_si256(v, _mm256_and_si256(upper, caseBit));
+            __m256i vowel = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('a')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('e'))),
+                _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('i')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('o'))),
+                                _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('u'))));
+            _mm256_storeu_si256((__m256i*)(s + i), _mm256_blendv_epi8(v, star, vowel));
+        }
+        addScalar(s + i, n - i);
+    }
+#endif
+};
+
+#ifdef A1_X86_SIMD
+__attribute__((target("avx2"))) static inline __m256i foldCaseAvx2(__m256i v) {
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+// Compares 32 bytes of the front with the byte-reversed 32 bytes at the
+// matching end of the back
+__attribute__((target("avx2"))) bool isMirrorAvx2(const char* front, const char* back, size_t n) {
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(front + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(back + n - i - 32));
+        b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, reverse), 0x4E);  // reverse all 32 bytes
+        __m256i same = _mm256_cmpeq_epi8(foldCaseAvx2(a), foldCaseAvx2(b));
+        if ((unsigned)_mm256_movemask_epi8(same) != 0xFFFFFFFFu) return false;
+    }
+    return isMirrorScalar(front + i, back, n - i);
+}
+#endif
+
+bool isMirror(const char* front, const char* back, size_t n) {
+#ifdef A1_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) return isMirrorAvx2(front, back, n);
+#endif
+    return isMirrorScalar(front, back, n);
+}
+
+// Case-insensitive palindrome check: the first half mirrors the second
+bool isPalindrome(const char* s, size_t n) {
+    return isMirror(s, s + n - n / 2, n / 2);
+}
+
+// Answers "is s[l..r] a palindrome" in O(1) after an O(n) Manacher pass.
+// Case is always ignored, like the whole-string check; with ignoreSpaces
+// the spaces are dropped first and ranges are mapped onto what is left.
+class PalindromeIndex {
+public:
+    struct Range {
+        size_t l, r;  // inclusive, indices into the original string
+    };
+
+    PalindromeIndex(const char* s, size_t n, bool ignoreSpaces = false) : n(n), ignoreSpaces(ignoreSpaces) {
+        text.reserve(n);
+        if (ignoreSpaces) kept.assign(n + 1, 0);
+        for (size_t i = 0; i < n; i++) {
+            if (ignoreSpaces) {
+                kept[i] = text.size();
+                if (s[i] == ' ') continue;
+                origin.push_back(i);
+            }
+            text.push_back((char)foldCase(s[i]));
+        }
+        if (ignoreSpaces) kept[n] = text.size();
+        build();
+    }
+
+    bool isPalindrome(size_t l, size_t r) const {
+        size_t a = ignoreSpaces ? kept[l] : l;
+        size_t b = ignoreSpaces ? kept[r + 1] : r + 1;  // filtered range [a, b)
+        if (b - a < 2) return true;
+        size_t length = b - a;
+        if (length % 2 == 1) return odd[(a + b) / 2] >= (length + 1) / 2;
+        return even[(a + b) / 2] >= length / 2;
+    }
+
+    // Answers queries[i] into result[i]
+    void query(const Range* queries, size_t count, bool* result) const {
+        for (size_t i = 0; i < count; i++) result[i] = isPalindrome(queries[i].l, queries[i].r);
+    }
+
+    // Longest palindromic substring as an original range; with spaces
+    // ignored it starts and ends on a kept character
+    Range longest() const {
+        if (text.empty()) return {0, 0};
+        size_t best = 1, start = 0;
+        for (size_t i = 0; i < text.size(); i++) {
+            if (2 * odd[i] - 1 > best) best = 2 * odd[i] - 1, start = i - odd[i] + 1;
+            if (2 * even[i] > best) best = 2 * even[i], start = i - even[i];
+        }
+        if (!ignoreSpaces) return {start, start + best - 1};
+        return {origin[start], origin[start + best - 1]};
+    }
+
+    // Length of the filtered text the index is built on
+    size_t size() const { return text.size(); }
+
+private:
+    size_t n;
+    bool ignoreSpaces;
+    string text;              // case-folded, spaces removed if asked
+    vector<size_t> kept;    // kept[i]: filtered characters before s[i]
+    vector<size_t> origin;  // original index of each filtered character
+    vector<size_t> odd;     // odd[i]: radius of the longest odd palindrome centred on i (itself counts)
+    vector<size_t> even;    // even[i]: half length of the longest even palindrome centred before i
+
+    void build() {
+        size_t m = text.size();
+        odd.assign(m, 0);
+        even.assign(m, 0);
+        for (size_t i = 0, l = 0, r = 0; i < m; i++) {  // [l, r) is the rightmost palindrome found
+            size_t k = i < r ? min(odd[l + r - 1 - i], r - i) : 1;
+            while (i + k < m && k <= i && text[i + k] == text[i - k]) k++;
+            odd[i] = k;
+            if (i + k > r) l = i - k + 1, r = i + k;
+        }
+        for (size_t i = 0, l = 0, r = 0; i < m; i++) {
+            size_t k = i < r ? min(even[l + r - i], r - i) : 0;
+            while (i + k < m && k + 1 <= i && text[i + k] == text[i - k - 1]) k++;
+            even[i] = k;
+            if (i + k > r) l = i - k, r = i + k;
+        }
+    }
+};
+
+// Code point frequencies of UTF-8 text. ASCII goes through LetterCounter
+// (so a-z stay case-insensitive as before); the few distinct non-ASCII
+// code points are counted in a small open-addressing table.
+class Utf8Counter {
+public:
+    Utf8Counter() : invalid(false), errorAt(0), keys(64, 0), counts(64, 0), used(0) {}
+
+    // Counts the code points of s[0..n), which starts at byte offset of the
+    // input. Returns the number of bytes used: a sequence cut off by the
+    // end of the buffer is left for the next call. On invalid UTF-8, sets
+    // invalid and errorAt and stops.
+    size_t add(const char* s, size_t n, uint64_t offset) {
+#ifdef A1_X86_SIMD
+        if (__builtin_cpu_supports("avx2")) return addAvx2(s, n, offset);
+#endif
+        return decode(s, n, 0, n, offset);
+    }
+
+    void frequencies(uint64_t frequency[26]) const { ascii.frequencies(frequency); }
+
+    // Non-ASCII code points with their counts, in code point order
+    vector<pair<uint32_t, uint64_t>> others() const {
+        vector<pair<uint32_t, uint64_t>> result;
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] != 0) result.push_back({keys[i], counts[i]});
+        }
+        sort(result.begin(), result.end());
+        return result;
+    }
+
+    bool invalid;
+    uint64_t errorAt;
+
+private:
+    LetterCounter ascii;
+    vector<uint32_t> keys;   // 0 marks an empty slot, it is never a non-ASCII code point
+    vector<uint64_t> counts;
+    size_t used;
+
+    void bump(uint32_t cp) {
+        size_t mask = keys.size() - 1;
+        size_t i = (cp * 0x9E3779B1u) & mask;
+        while (keys[i] != cp) {
+            if (keys[i] == 0) return insert(cp);
+            i = (i + 1) & mask;
+        }
+        counts[i]++;
+    }
+
+    // First sighting of cp, kept out of line so bump stays small
+    __attribute__((noinline)) void insert(uint32_t cp) {
+        if (2 * (used + 1) > keys.size()) grow();
+        size_t mask = keys.size() - 1;
+        size_t i = (cp * 0x9E3779B1u) & mask;
+        while (keys[i] != 0) i = (i + 1) & mask;
+        keys[i] = cp;
+        counts[i] = 1;
+        used++;
+    }
+
+    void grow() {
+        vector<uint32_t> oldKeys(keys.size() * 2, 0);
+        vector<uint64_t> oldCounts(counts.size() * 2, 0);
+        oldKeys.swap(keys);
+        oldCounts.swap(counts);
+        size_t mask = keys.size() - 1;
+        for (size_t j = 0; j < oldKeys.size(); j++) {
+            if (oldKeys[j] == 0) continue;
+            size_t i = (oldKeys[j] * 0x9E3779B1u) & mask;
+            while (keys[i] != 0) i = (i + 1) & mask;
+            keys[i] = oldKeys[j];
+            counts[i] = oldCounts[j];
+        }
+    }
+
+    // Decodes from s[i] until at least s[stop], validating as it goes
+    // (no overlong forms, surrogates or code points past U+10FFFF)
+    size_t decode(const char* s, size_t n, size_t i, size_t stop, uint64_t offset) {
+        const unsigned char* u = (const unsigned char*)s;
+        while (i < stop) {
+            unsigned char b = u[i];
+            if (b < 0x80) {
+                ascii.table[0][b]++;
+                i++;
+                continue;
+            }
+            size_t length;
+            unsigned char low = 0x80, high = 0xBF;
+            uint32_t cp;
+            if (b >= 0xC2 && b <= 0xDF) length = 2, cp = b & 0x1F;
+            else if (b >= 0xE0 && b <= 0xEF) {
+                length = 3, cp = b & 0x0F;
+                if (b == 0xE0) low = 0xA0;
+                if (b == 0xED) high = 0x9F;
+            } else if (b >= 0xF0 && b <= 0xF4) {
+                length = 4, cp = b & 0x07;
+                if (b == 0xF0) low = 0x90;
+                if (b == 0xF4) high = 0x8F;
+            } else return fail(i, offset);
+            for (size_t k = 1; k < length; k++) {
+                if (i + k == n) return i;  // cut off, finish it with the next buffer
+                unsigned char c = u[i + k];
+                if (c < low || c > high) return fail(i, offset);
+                low = 0x80, high = 0xBF;
+                cp = cp << 6 | (c & 0x3F);
+            }
+            bump(cp);
+            i += length;
+        }
+        return i;
+    }
+
+    // One multi-byte sequence at u[i] with four readable bytes, decoded
+    // without branches on its length; returns i when it is not valid
+    size_t decodeOne(const unsigned char* u, size_t i) {
+        // tail marks the bits of the third and fourth bytes that must read
+        // 10 for a continuation; shift drops the bytes past the sequence
+        struct Lead { unsigned char length, low, high, bits, shift; uint32_t tail; };
+        static constexpr struct LeadTable {
+            Lead lead[256] = {};
+            constexpr LeadTable() {
+                for (int b = 0; b < 256; b++) {
+                    Lead& l = lead[b];
+                    l = {0, 0xFF, 0, 0, 0, 0};  // rejects every second byte
+                    if (b >= 0xC2 && b <= 0xDF) l = {2, 0x80, 0xBF, 0x1F, 12, 0};
+                    if (b >= 0xE0 && b <= 0xEF) l = {3, (unsigned char)(b == 0xE0 ? 0xA0 : 0x80), (unsigned char)(b == 0xED ? 0x9F : 0xBF), 0x0F, 6, 0x00C00000};
+                    if (b >= 0xF0 && b <= 0xF4) l = {4, (unsigned char)(b == 0xF0 ? 0x90 : 0x80), (unsigned char)(b == 0xF4 ? 0x8F : 0xBF), 0x07, 0, 0xC0C00000};
+                }
+            }
+        } table;
+        const Lead& l = table.lead[u[i]];
+        uint32_t word;  // u[i] in the low byte
+        memcpy(&word, u + i, 4);
+        unsigned char b1 = u[i + 1];
+        if (b1 < l.low || b1 > l.high || (word & l.tail) != (l.tail & 0x80808080u)) return i;
+        uint32_t cp = (uint32_t)(u[i] & l.bits) << 18 | (uint32_t)(b1 & 0x3F) << 12 | (word >> 16 & 0x3F) << 6 | (word >> 24 & 0x3F);
+        bump(cp >> l.shift);
+        return i + l.length;
+    }
+
+    size_t fail(size_t i, uint64_t offset) {
+        invalid = true;
+        errorAt = offset + i;
+        return i;
+    }
+
+#ifdef A1_X86_SIMD
+    // Continuation bytes (10xxxxxx) counted so far; LetterCounter counts
+    // every byte value, not only the letters
+    uint64_t continuations() const {
+        uint64_t total = 0;
+        for (int t = 0; t < 4; t++) {
+            for (int b = 0x80; b < 0xC0; b++) total += ascii.table[t][b];
+        }
+        return total;
+    }
+
+    // Blocks are counted whole (high bytes land in table entries that are
+    // never read) while the positions of lead bytes are collected without
+    // branching on them; the sequences are decoded a stretch at a time.
+    // A stray continuation byte makes the continuations counted differ
+    // from the ones decoded. Any error rescans the buffer with decode,
+    // which finds the first one.
+    __attribute__((target("avx2"))) size_t addAvx2(const char* s, size_t n, uint64_t offset) {
+        const unsigned char* u = (const unsigned char*)s;
+        const __m256i leadMin = _mm256_set1_epi8((char)0xC0);
+        const size_t STRETCH = 1024;
+        uint32_t lead[STRETCH];
+        uint64_t before = continuations(), decoded = 0;
+        size_t i = 0, done = 0;  // bytes before done belong to decoded sequences
+        while (i + 64 + 3 <= n) {  // a lead in a block has its three next bytes
+            size_t stop = min(n - 3, i + STRETCH), k = 0;
+            for (; i + 64 <= stop; i += 64) {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(s + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(s + i + 32));
+                uint64_t leads = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(a, leadMin), a))
+                    | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(b, leadMin), b)) << 32;
+                ascii.count(s + i, 64);
+                lead[k] = (uint32_t)(i + __builtin_ctzll(leads | 1ull << 63));  // kept only if there is a lead
+                k += leads != 0;
+                for (leads &= leads - 1; leads != 0; leads &= leads - 1) lead[k++] = (uint32_t)(i + __builtin_ctzll(leads));
+            }
+            for (size_t j = 0; j < k; j++) {
+                done = decodeOne(u, lead[j]);
+                if (done == lead[j]) return decode(s, n, 0, n, offset);
+                decoded += done - lead[j] - 1;
+            }
+        }
+        if (done > i) decoded -= done - i;  // the end of the last sequence was not counted
+        if (continuations() - before != decoded) return decode(s, n, 0, n, offset);
+        return decode(s, n, max(i, done), n, offset);
+    }
+#endif
+};
+
+// pread until n bytes are in or the file ends
+bool readAt(int fd, char* buf, size_t n, uint64_t offset) {
+    while (n > 0) {
+        ssize_t got = pread(fd, buf, n, offset);
+        if (got <= 0) return false;
+        buf += got;
+        n -= got;
+        offset += got;
+    }
+    return true;
+}
+
+const size_t STREAM_CHUNK = 1 << 20;
+
+// Two-ended palindrome check on a file: one chunk from each end is read
+// per step, so only two chunks are resident however large the file is
+bool streamIsPalindrome(int fd, uint64_t size, bool& ok) {
+    vector<char> front(STREAM_CHUNK), back(STREAM_CHUNK);
+    uint64_t left = 0, right = size;
+    ok = true;
+    while (right - left > 1) {
+        size_t m = (size_t)min<uint64_t>(STREAM_CHUNK, (right - left) / 2);
+        if (!readAt(fd, front.data(), m, left) || !readAt(fd, back.data(), m, right - m)) return ok = false;
+        if (!isMirror(front.data(), back.data(), m)) return false;
+        left += m;
+        right -= m;
+    }
+    return true;
+}
+
+// Counts letters and rewrites vowels chunk by chunk on the pool, with one
+// counter per worker. Chunks are written in file order straight from the
+// buffer they were read into; at most 2 x threads chunks are in flight.
+bool streamRewrite(int fd, uint64_t size, WorkStealingPool& pool, FastWriter& out, uint64_t frequency[26]) {
+    uint64_t chunks = (size + STREAM_CHUNK - 1) / STREAM_CHUNK;
+    size_t window = 2 * pool.size();
+    vector<unique_ptr<char[]>> buffers(window);
+    vector<size_t> length(window, 0);
+    vector<char> ready(window, 0);
+    vector<LetterCounter> counters(pool.size());
+    mutex m;
+    condition_variable done;
+    auto launch = [&](uint64_t k) {
+        size_t slot = k % window;
+        if (!buffers[slot]) buffers[slot].reset(new char[STREAM_CHUNK]);
+        length[slot] = (size_t)min<uint64_t>(STREAM_CHUNK, size - k * STREAM_CHUNK);
+        if (!readAt(fd, buffers[slot].get(), length[slot], k * STREAM_CHUNK)) return false;
+        pool.submit([&, slot] {
+            counters[pool.workerIndex()].add(buffers[slot].get(), length[slot]);
+            lock_guard<mutex> lock(m);
+            ready[slot] = 1;
+            done.notify_all();
+        });
+        return true;
+    };
+    // nextLaunch counts only chunks that were submitted: after a failed
+    // read the loop below drains those and stops
+    bool ok = true;
+    uint64_t nextLaunch = 0;
+    while (ok && nextLaunch < chunks && nextLaunch < window) {
+        ok = launch(nextLaunch);
+        if (ok) nextLaunch++;
+    }
+    for (uint64_t k = 0; k < nextLaunch; k++) {
+        size_t slot = k % window;
         {
-            isPalin = false;
-            break;
+            unique_lock<mutex> lock(m);
+            done.wait(lock, [&] { return ready[slot] != 0; });
+            ready[slot] = 0;
+        }
+        out.write(buffers[slot].get(), length[slot]);
+        if (ok && nextLaunch < chunks) {
+            ok = launch(nextLaunch);
+            if (ok) nextLaunch++;
         }
-        left++;
-        right--;
     }
-    if (isPalin) {
-        cout << "The string is a palindrome." << endl;
-    } else {
-        cout << "The string is not a palindrome." << endl;
+    pool.wait();
+    for (int i = 0; i < 26; i++) frequency[i] = 0;
+    for (const LetterCounter& counter : counters) {
+        uint64_t part[26];
+        counter.frequencies(part);
+        for (int i = 0; i < 26; i++) frequency[i] += part[i];
     }
+    return ok;
+}
 
-    // Count Character Frequency (assuming - case insensitive)
-    int frequency[26] = {0};  // Array for counting letters from a to z
-    for (int i = 0; i < str.length(); i++) {
-        if (isalpha(str[i])) {
-            char ch = tolower(str[i]);
-            frequency[ch - 'a']++;  // Increment frequency of the character
+// --stream file [threads] runs the same checks on a whole file without
+// loading it; the modified text is written before the frequencies, as it
+// is only complete once the last chunk is counted
+int runStream(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " --stream file [threads]" << endl;
+        return 1;
+    }
+    int fd = open(argv[2], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        cerr << "Cannot read " << argv[2] << endl;
+        return 1;
+    }
+    uint64_t size = st.st_size;
+    // the trailing line break is not part of the text for the palindrome test
+    char tail[2];
+    size_t tailSize = (size_t)min<uint64_t>(2, size);
+    uint64_t textSize = size;
+    if (tailSize > 0 && readAt(fd, tail, tailSize, size - tailSize) && tail[tailSize - 1] == '\n') {
+        textSize--;
+        if (tailSize == 2 && tail[0] == '\r') textSize--;
+    }
+    FastWriter out;
+    bool ok;
+    bool palindrome = streamIsPalindrome(fd, textSize, ok);
+    WorkStealingPool pool(argc > 3 ? atoi(argv[3]) : 0);
+    uint64_t frequency[26];
+    if (ok) {
+        out << (palindrome ? "The string is a palindrome." : "The string is not a palindrome.") << '\n';
+        out << "Modified string : ";
+        ok = streamRewrite(fd, size, pool, out, frequency);
+    }
+    close(fd);
+    if (!ok) {
+        out.flush();
+        cerr << "Read error on " << argv[2] << endl;
+        return 1;
+    }
+    if (textSize == size) out << '\n';
+    out << "Character frequencies (case-insensitive):" << '\n';
+    for (int i = 0; i < 26; i++) {
+        if (frequency[i] > 0) {
+            out << char(i + 'a') << ": " << frequency[i] << '\n';
+        }
+    }
+    return 0;
+}
+
+// Writes one code point back as UTF-8
+void writeUtf8(FastWriter& out, uint32_t cp) {
+    char b[4];
+    size_t n;
+    if (cp < 0x800) b[0] = (char)(0xC0 | cp >> 6), n = 2;
+    else if (cp < 0x10000) b[0] = (char)(0xE0 | cp >> 12), n = 3;
+    else b[0] = (char)(0xF0 | cp >> 18), n = 4;
+    for (size_t k = 1; k < n; k++) b[k] = (char)(0x80 | ((cp >> (6 * (n - 1 - k))) & 0x3F));
+    out.write(b, n);
+}
+
+// --utf8 file counts code points of a UTF-8 file: a-z case-insensitive as
+// in the default mode, then every non-ASCII code point
+int runUtf8(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " --utf8 file" << endl;
+        return 1;
+    }
+    int fd = open(argv[2], O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot read " << argv[2] << endl;
+        return 1;
+    }
+    Utf8Counter counter;
+    vector<char> buffer(STREAM_CHUNK + 4);
+    size_t carry = 0;  // bytes of a sequence cut by the previous chunk
+    uint64_t offset = 0;
+    while (!counter.invalid) {
+        ssize_t got = read(fd, buffer.data() + carry, STREAM_CHUNK);
+        if (got < 0) {
+            close(fd);
+            cerr << "Read error on " << argv[2] << endl;
+            return 1;
         }
+        size_t n = carry + got;
+        size_t used = counter.add(buffer.data(), n, offset);
+        if (got == 0) {
+            if (used < n && !counter.invalid) counter.invalid = true, counter.errorAt = offset + used;
+            break;
+        }
+        carry = n - used;
+        memmove(buffer.data(), buffer.data() + used, carry);
+        offset += used;
+    }
+    close(fd);
+    if (counter.invalid) {
+        cerr << "Invalid UTF-8 at byte " << counter.errorAt << endl;
+        return 1;
     }
-    cout << "Character frequencies (case-insensitive):" << endl;
+    FastWriter out;
+    uint64_t frequency[26];
+    counter.frequencies(frequency);
+    out << "Character frequencies (case-insensitive):" << '\n';
     for (int i = 0; i < 26; i++) {
         if (frequency[i] > 0) {
-            cout << char(i + 'a') << ": " << frequency[i] << endl;
+            out << char(i + 'a') << ": " << frequency[i] << '\n';
+        }
+    }
+    for (const auto& entry : counter.others()) {
+        char code[16];
+        snprintf(code, sizeof(code), " (U+%04X): ", (unsigned)entry.first);
+        writeUtf8(out, entry.first);
+        out << code << entry.second << '\n';
+    }
+    return 0;
+}
+
+// --bench [MB] measures GB/s of the old loops against the new kernels
+int runBench(int argc, char* argv[]) {
+    size_t n = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 256) << 20;
+    string text(n, ' ');
+    uint32_t seed = 2463534242u;
+    const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ ,.";
+    for (size_t i = 0; i < n / 2; i++) {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        text[i] = alphabet[seed % (sizeof(alphabet) - 1)];
+        text[n - 1 - i] = (char)toupper(text[i]);  // a palindrome, so no early exit
+    }
+    FastWriter out;
+    auto time = [&](const char* label, auto body) {
+        string copy = text;
+        auto start = chrono::steady_clock::now();
+        long long check = body(copy);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        out << label << ": " << (long long)(n / seconds / 1e6) << " MB/s (check " << check << ")\n";
+    };
+    time("palindrome, tolower loop     ", [&](string& str) {
+        size_t left = 0, right = str.length() - 1;
+        while (left < right && tolower(str[left]) == tolower(str[right])) left++, right--;
+        return (long long)(left >= right);
+    });
+    time("palindrome, avx2 blocks      ", [&](string& str) { return (long long)isPalindrome(str.data(), str.size()); });
+    time("count + vowels, 3 passes     ", [&](string& str) {
+        long long frequency[26] = {0};
+        for (size_t i = 0; i < str.length(); i++)
+            if (isalpha(str[i])) frequency[tolower(str[i]) - 'a']++;
+        for (size_t i = 0; i < str.length(); i++) {
+            char ch = tolower(str[i]);
+            if (ch == 'a' || ch == 'e' || ch == 'i' || ch == 'o' || ch == 'u') str[i] = '*';
         }
+        return frequency[0] + (str[0] == '*');
+    });
+    time("count + vowels, fused scalar ", [&](string& str) {
+        LetterCounter counter;
+        uint64_t frequency[26];
+        counter.addScalar(&str[0], str.size());
+        counter.frequencies(frequency);
+        return (long long)frequency[0] + (str[0] == '*');
+    });
+    time("count + vowels, fused avx2   ", [&](string& str) {
+        LetterCounter counter;
+        uint64_t frequency[26];
+        counter.add(&str[0], str.size());
+        counter.frequencies(frequency);
+        return (long long)frequency[0] + (str[0] == '*');
+    });
+    return 0;
+}
+
+// --queries [--ignore-spaces] reads the string from the first line of
+// input, then "l r" pairs (0-based, inclusive) until the end of input,
+// answers each one and finally prints the longest palindrome
+int runQueries(int argc, char* argv[]) {
+    bool ignoreSpaces = argc > 2 && string(argv[2]) == "--ignore-spaces";
+    FastWriter out;
+    FastReader in(0, &out);
+    string str;
+    in.readLine(str);
+    PalindromeIndex index(str.data(), str.size(), ignoreSpaces);
+    vector<PalindromeIndex::Range> queries;
+    size_t l, r;
+    while (in.readInt(l) && in.readInt(r)) {
+        if (l > r || r >= str.size()) {
+            cerr << "Invalid range " << l << " " << r << endl;
+            return 1;
+        }
+        queries.push_back({l, r});
     }
-    // Replace Vowels with '*'
-    for (int i = 0; i < str.length(); i++) {
-        char ch = tolower(str[i]);
-        if (ch == 'a' || ch == 'e' || ch == 'i' || ch == 'o' || ch == 'u') {
-            str[i] = '*';  // Replace vowel with '*'
+    unique_ptr<bool[]> answers(new bool[queries.size()]);
+    index.query(queries.data(), queries.size(), answers.get());
+    for (size_t i = 0; i < queries.size(); i++) out << (answers[i] ? "yes" : "no") << '\n';
+    PalindromeIndex::Range best = index.longest();
+    if (!str.empty()) {
+        out << "Longest palindrome: [" << best.l << ", " << best.r << "] ";
+        out.write(str.data() + best.l, best.r - best.l + 1);
+        out << '\n';
+    }
+    return 0;
+}
+
+// --bench-index [MB] [queries] times the index build and its queries
+// against checking every range directly
+int runIndexBench(int argc, char* argv[]) {
+    size_t n = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 64) << 20;
+    size_t count = argc > 3 ? strtoull(argv[3], nullptr, 10) : 10000000;
+    string text(n, ' ');
+    uint32_t seed = 2463534242u;
+    auto next = [&] {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        return seed;
+    };
+    for (size_t i = 0; i < n; i++) text[i] = "abAB"[next() % 4];  // small alphabet, many palindromes
+    vector<PalindromeIndex::Range> queries(count);
+    for (auto& q : queries) {
+        q.l = next() % n;
+        q.r = min(n - 1, q.l + next() % 64);
+        if (next() % 2) {  // half of them real palindromes, so direct checks run full length
+            size_t centre = q.l, radius = 0;
+            while (radius < 200 && centre >= radius + 1 && centre + radius + 1 < n &&
+                   foldCase(text[centre - radius - 1]) == foldCase(text[centre + radius + 1])) radius++;
+            q.l = centre - radius, q.r = centre + radius;
+        }
+    }
+    FastWriter out;
+    auto start = chrono::steady_clock::now();
+    PalindromeIndex index(text.data(), n);
+    double build = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    unique_ptr<bool[]> fast(new bool[count]), direct(new bool[count]);
+    start = chrono::steady_clock::now();
+    index.query(queries.data(), count, fast.get());
+    double indexed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) direct[i] = isPalindrome(text.data() + queries[i].l, queries[i].r - queries[i].l + 1);
+    double scanned = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t yes = 0, mismatches = 0;
+    for (size_t i = 0; i < count; i++) yes += fast[i], mismatches += fast[i] != direct[i];
+    PalindromeIndex::Range best = index.longest();
+    out << "build: " << (long long)(build * 1000) << " ms for " << (long long)(n >> 20) << " MB\n";
+    out << "index queries : " << (long long)(count / indexed) << " /s\n";
+    out << "direct checks : " << (long long)(count / scanned) << " /s\n";
+    out << yes << " of " << count << " are palindromes, " << mismatches << " mismatches, longest " << best.r - best.l + 1 << '\n';
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --bench-utf8 [MB] compares the ASCII letter count with the UTF-8
+// counter on pure ASCII and on mostly ASCII text
+int runUtf8Bench(int argc, char* argv[]) {
+    size_t n = (argc > 2 ? strtoull(argv[2], nullptr, 10) : 256) << 20;
+    string ascii(n, ' '), mixed;
+    mixed.reserve(n + 64);
+    uint32_t seed = 2463534242u;
+    const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ ,.";
+    const char* accents[] = {"\xC3\xA9", "\xC3\xBC", "\xE2\x82\xAC", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80"};
+    for (size_t i = 0; i < n; i++) {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        ascii[i] = alphabet[seed % (sizeof(alphabet) - 1)];
+        if (seed % 256 == 0) mixed += accents[(seed >> 8) % 5];  // about one in 256 characters
+        else if (mixed.size() < n) mixed += ascii[i];
+    }
+    mixed.resize(n);  // a cut sequence at the end is simply left unused
+    FastWriter out;
+    auto time = [&](const char* label, const string& text, auto body) {
+        double seconds = 1e9;
+        uint64_t check = 0;
+        for (int run = 0; run < 5; run++) {  // best of 5, the kernels are close
+            auto start = chrono::steady_clock::now();
+            check = body(text);
+            seconds = min(seconds, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        }
+        out << label << ": " << (long long)(text.size() / seconds / 1e6) << " MB/s (check " << check << ")\n";
+    };
+    auto letters = [](const string& text) {
+        LetterCounter counter;
+        uint64_t frequency[26];
+        counter.count(text.data(), text.size());
+        counter.frequencies(frequency);
+        return frequency[0];
+    };
+    auto utf8 = [](const string& text) {
+        Utf8Counter counter;
+        uint64_t frequency[26];
+        counter.add(text.data(), text.size(), 0);
+        counter.frequencies(frequency);
+        return frequency[0] + counter.others().size();
+    };
+    time("ascii letters, ascii text  ", ascii, letters);
+    time("utf-8 counter, ascii text  ", ascii, utf8);
+    time("ascii letters, mixed text  ", mixed, letters);
+    time("utf-8 counter, mixed text  ", mixed, utf8);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") return runBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--stream") return runStream(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--utf8") return runUtf8(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-utf8") return runUtf8Bench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--queries") return runQueries(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-index") return runIndexBench(argc, argv);
+
+    FastWriter out;
+    FastReader in(0, &out);
+    string str;
+    out << "Enter a string: ";
+    in.readLine(str);
+
+    // Palindrome Check (ignoring case), 32 mirrored bytes at a time
+    if (isPalindrome(str.data(), str.size())) {
+        out << "The string is a palindrome." << '\n';
+    } else {
+        out << "The string is not a palindrome." << '\n';
+    }
+
+    // Count Character Frequency (case insensitive) and replace vowels with '*' in one pass
+    LetterCounter counter;
+    counter.add(&str[0], str.size());
+    uint64_t frequency[26];  // Array for counting letters from a to z
+    counter.frequencies(frequency);
+    out << "Character frequencies (case-insensitive):" << '\n';
+    for (int i = 0; i < 26; i++) {
+        if (frequency[i] > 0) {
+            out << char(i + 'a') << ": " << frequency[i] << '\n';
         }
     }
-    cout << "Modified string : " << str << endl;
+    out << "Modified string : " << str << '\n';
     return 0; //b_s
 }
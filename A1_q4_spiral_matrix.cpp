@@ -1,66 +1,583 @@
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <charconv>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include "A1_fast_io.h"
+#include "A1_matrix.h"
+#include "A1_thread_pool.h"
 using namespace std;
 
-void displayMatrix(int matrix[100][100], int n) 
+void displayMatrix(MatrixView<const int> matrix, FastWriter& out)
 {
-    cout << "\nMatrix Representation:\n";
-    for (int i = 0; i < n; i++) 
+    out << "\nMatrix Representation:\n";
+    for (size_t i = 0; i < matrix.rows(); i++)
     {
-        for (int j = 0; j < n; j++) 
+        for (size_t j = 0; j < matrix.cols(); j++)
         {
-            cout << matrix[i][j] << "\t";
+            out << matrix(i, j) << "\t";
         }
-        cout << "\n";
+        out << "\n";
     }
 }
-void printSpiral(int matrix[100][100], int n) 
+
+// Position in spiral order where layer L (the ring at distance L from
+// the border) starts: every earlier ring has 2(rows + cols) - 8l - 4 cells
+inline size_t spiralOffset(size_t rows, size_t cols, size_t layer)
+{
+    return 2 * layer * (rows + cols) - 4 * layer * layer;
+}
+
+// Layers whose columns are collected in one sweep over the rows; 16 ints
+// of a row are one cache line
+const size_t SPIRAL_GROUP = 16;
+
+inline size_t spiralLayers(size_t rows, size_t cols)
+{
+    return (min(rows, cols) + 1) / 2;
+}
+
+// Layer holding spiral position k: the largest L with spiralOffset(L) <= k,
+// from the quadratic 4L^2 - 2(rows + cols)L + k = 0, then corrected for
+// rounding
+inline size_t spiralLayerAt(size_t rows, size_t cols, size_t k)
+{
+    long double sum = (long double)rows + cols;
+    size_t layer = (size_t)((sum - sqrtl(max(0.0L, sum * sum - 4.0L * k))) / 4);
+    size_t layers = spiralLayers(rows, cols);
+    if (layer >= layers) layer = layers - 1;
+    while (layer > 0 && spiralOffset(rows, cols, layer) > k) layer--;
+    while (layer + 1 < layers && spiralOffset(rows, cols, layer + 1) <= k) layer++;
+    return layer;
+}
+
+struct SpiralCell
+{
+    size_t row, col;
+};
+
+// Row and column of spiral position k (k < rows * cols) in O(1)
+inline SpiralCell spiralCell(size_t rows, size_t cols, size_t k)
+{
+    size_t layer = spiralLayerAt(rows, cols, k);
+    size_t p = k - spiralOffset(rows, cols, layer);
+    size_t width = cols - 2 * layer, height = rows - 2 * layer;
+    if (p < width) return {layer, layer + p};
+    p -= width;
+    if (p < height - 1) return {layer + 1 + p, cols - 1 - layer};
+    p -= height - 1;
+    if (p < width - 1) return {rows - 1 - layer, cols - 2 - layer - p};
+    p -= width - 1;
+    return {rows - 2 - layer - p, layer};
+}
+
+// Spiral position of matrix[row][col], the inverse of spiralCell
+inline size_t spiralIndex(size_t rows, size_t cols, size_t row, size_t col)
+{
+    size_t layer = min(min(row, col), min(rows - 1 - row, cols - 1 - col));
+    size_t width = cols - 2 * layer, height = rows - 2 * layer;
+    size_t base = spiralOffset(rows, cols, layer);
+    if (row == layer) return base + col - layer;
+    if (col == cols - 1 - layer) return base + width + row - layer - 1;
+    if (row == rows - 1 - layer) return base + width + height - 1 + (cols - 2 - layer - col);
+    return base + 2 * width + height - 2 + (rows - 2 - layer - row);
+}
+
+// Positions [first, last) of the spiral as a lazy range of cells. Only
+// the start is placed with spiralCell, ++ then walks the ring in O(1).
+class SpiralRange
 {
-    int top = 0, bottom = n - 1, left = 0, right = n - 1;
-    cout << "\nSpiral Order Output:\n";
-    while (top <= bottom && left <= right) 
+public:
+    class iterator
     {
+    public:
+        iterator(size_t rows, size_t cols, size_t k) : rows(rows), cols(cols), k(k), left(0)
+        {
+            if (k >= rows * cols) return;
+            layer = spiralLayerAt(rows, cols, k);
+            size_t p = k - spiralOffset(rows, cols, layer);
+            for (side = 0; p >= sideLength(side); side++) p -= sideLength(side);
+            startSide();
+            left -= p;
+            cell.row += p * rowStep;
+            cell.col += p * colStep;
+        }
+
+        const SpiralCell& operator*() const { return cell; }
+        const SpiralCell* operator->() const { return &cell; }
+        bool operator==(const iterator& other) const { return k == other.k; }
+        bool operator!=(const iterator& other) const { return k != other.k; }
+
+        // Position in spiral order, and cells left before the next turn
+        size_t index() const { return k; }
+        size_t straight() const { return left; }
+        ptrdiff_t rowStepOf() const { return rowStep; }
+        ptrdiff_t colStepOf() const { return colStep; }
+
+        iterator& operator++()
+        {
+            k++;
+            if (--left > 0)
+            {
+                cell.row += rowStep;
+                cell.col += colStep;
+                return *this;
+            }
+            if (k >= rows * cols) return *this;
+            do
+            {
+                if (++side == 4) side = 0, layer++;
+            } while (sideLength(side) == 0);
+            startSide();
+            return *this;
+        }
+
+        // Moves n cells ahead on the current straight run (n < straight())
+        // or anywhere further via the closed form
+        iterator& operator+=(size_t n)
+        {
+            if (n < left)
+            {
+                k += n;
+                left -= n;
+                cell.row += n * rowStep;
+                cell.col += n * colStep;
+                return *this;
+            }
+            return *this = iterator(rows, cols, k + n);
+        }
+
+    private:
+        size_t rows, cols, k, layer = 0, left;
+        int side = 0;
+        ptrdiff_t rowStep = 0, colStep = 0;
+        SpiralCell cell = {0, 0};
+
+        size_t sideLength(int s) const
+        {
+            size_t width = cols - 2 * layer, height = rows - 2 * layer;
+            if (s == 0) return width;
+            if (s == 1) return height - 1;
+            if (s == 2) return height > 1 ? width - 1 : 0;
+            return height > 1 && width > 1 ? height - 2 : 0;
+        }
+
+        void startSide()
+        {
+            left = sideLength(side);
+            if (side == 0) cell = {layer, layer}, rowStep = 0, colStep = 1;
+            if (side == 1) cell = {layer + 1, cols - 1 - layer}, rowStep = 1, colStep = 0;
+            if (side == 2) cell = {rows - 1 - layer, cols - 2 - layer}, rowStep = 0, colStep = -1;
+            if (side == 3) cell = {rows - 2 - layer, layer}, rowStep = -1, colStep = 0;
+        }
+    };
+
+    SpiralRange(size_t rows, size_t cols, size_t first, size_t last)
+        : rows(rows), cols(cols), first(first), last(last) {}
+
+    iterator begin() const { return iterator(rows, cols, first); }
+    iterator end() const { return iterator(rows, cols, last); }
+
+private:
+    size_t rows, cols, first, last;
+};
+
+// Writes the spiral order of layers [first, last) to dest, which holds
+// the part from spiralOffset(first) on. Rows are one memcpy (or reversed
+// copy) each. Walking a column for every layer would cost a cache miss per
+// element, so the right and left columns of all the layers are collected
+// together, row by row, where they sit side by side.
+template <class T>
+void spiralCopyLayers(MatrixView<const T> matrix, size_t first, size_t last, T* dest)
+{
+    size_t rows = matrix.rows(), cols = matrix.cols();
+    ptrdiff_t colStep = matrix.colStride();
+    size_t base = spiralOffset(rows, cols, first);
+    auto offset = [&](size_t layer) { return dest + spiralOffset(rows, cols, layer) - base; };
+    for (size_t layer = first; layer < last; layer++)
+    {
+        size_t width = cols - 2 * layer, height = rows - 2 * layer;
+        T* d = offset(layer);
         // Moving left --> right
-        for (int i = left; i <= right; i++)
-            cout << matrix[top][i] << " ";
-        top++;
-        // Moving top --> bottom
-        for (int i = top; i <= bottom; i++)
-            cout << matrix[i][right] << " ";
-        right--;
-        // Moving right --> left (if still in boundary)
-        if (top <= bottom) 
-        {
-            for (int i = right; i >= left; i--)
-                cout << matrix[bottom][i] << " ";
-            bottom--;
+        const T* top = &matrix(layer, layer);
+        if (colStep == 1)
+            memcpy(d, top, width * sizeof(T));
+        else
+            for (size_t k = 0; k < width; k++) d[k] = top[k * colStep];
+        // Moving right --> left
+        if (height > 1)
+        {
+            const T* row = &matrix(rows - 1 - layer, cols - 2 - layer);
+            T* back = d + width + height - 1;
+            for (size_t k = 0; k + 1 < width; k++) back[k] = row[-(ptrdiff_t)k * colStep];
+        }
+    }
+    for (size_t group = first; group < last; group += SPIRAL_GROUP)
+    {
+        size_t groupEnd = min(last, group + SPIRAL_GROUP);
+        for (size_t i = group + 1; i + group < rows; i++)
+        {
+            const T* row = &matrix(i, 0);
+            for (size_t layer = group; layer < groupEnd && i + layer < rows; layer++)
+            {
+                size_t width = cols - 2 * layer, height = rows - 2 * layer;
+                // Moving top --> bottom, rows layer + 1 .. rows - 1 - layer
+                if (i > layer)
+                    offset(layer)[width + i - layer - 1] = row[(ptrdiff_t)(cols - 1 - layer) * colStep];
+                // Moving bottom --> top, rows rows - 2 - layer .. layer + 1
+                if (width > 1 && i > layer && i + layer + 2 <= rows)
+                    offset(layer)[2 * width + 2 * height - 4 + layer - i] = row[(ptrdiff_t)layer * colStep];
+            }
+        }
+    }
+}
+
+// Spiral order into dest (matrix.size() elements)
+template <class T>
+void spiralCopy(MatrixView<const T> matrix, T* dest)
+{
+    spiralCopyLayers(matrix, 0, spiralLayers(matrix.rows(), matrix.cols()), dest);
+}
+
+// Spiral positions [first, last) into dest. Whole layers in the range
+// take the blocked copy; the partial rings at either end are walked one
+// straight run at a time with SpiralRange.
+template <class T>
+void spiralCopyRange(MatrixView<const T> matrix, size_t first, size_t last, T* dest)
+{
+    size_t rows = matrix.rows(), cols = matrix.cols();
+    auto walk = [&](size_t from, size_t to)
+    {
+        SpiralRange::iterator it(rows, cols, from);
+        while (it.index() < to)
+        {
+            size_t n = min(it.straight(), to - it.index());
+            const T* src = &matrix(it->row, it->col);
+            ptrdiff_t step = it.rowStepOf() * matrix.rowStride() + it.colStepOf() * matrix.colStride();
+            T* d = dest + (it.index() - first);
+            if (step == 1)
+                memcpy(d, src, n * sizeof(T));
+            else
+                for (size_t k = 0; k < n; k++) d[k] = src[k * step];
+            it += n;
+        }
+    };
+    if (first >= last) return;
+    size_t layers = spiralLayers(rows, cols);
+    size_t a = spiralLayerAt(rows, cols, first);
+    if (spiralOffset(rows, cols, a) < first) a++;
+    size_t b = last == matrix.size() ? layers : spiralLayerAt(rows, cols, last);
+    if (a >= b)
+    {
+        walk(first, last);
+        return;
+    }
+    size_t whole = spiralOffset(rows, cols, a), wholeEnd = b == layers ? matrix.size() : spiralOffset(rows, cols, b);
+    walk(first, whole);
+    spiralCopyLayers(matrix, a, b, dest + (whole - first));
+    walk(wholeEnd, last);
+}
+
+// Spiral order into dest, cut into equal slices of positions that the
+// pool copies in parallel, each straight to its own offset of dest
+template <class T>
+void parallelSpiralCopy(MatrixView<const T> matrix, T* dest, WorkStealingPool& pool)
+{
+    size_t total = matrix.size(), slices = 4 * pool.size();
+    for (size_t t = 0; t < slices; t++)
+    {
+        size_t first = total * t / slices, last = total * (t + 1) / slices;
+        pool.submit([matrix, dest, first, last] { spiralCopyRange(matrix, first, last, dest + first); });
+    }
+    pool.wait();
+}
+
+// Text of spiral positions [first, last), "v " per value
+string formatSpiralSlice(MatrixView<const int> matrix, size_t first, size_t last)
+{
+    thread_local vector<int> values;
+    values.resize(last - first);
+    spiralCopyRange(matrix, first, last, values.data());
+    string text(values.size() * 12, '\0');
+    char* p = &text[0];
+    for (int v : values)
+    {
+        p = to_chars(p, p + 11, v).ptr;
+        *p++ = ' ';
+    }
+    text.resize(p - text.data());
+    return text;
+}
+
+// printSpiral with the formatting spread over the pool; slices are
+// written in order, with at most 4 x threads of them in memory
+void printSpiralParallel(MatrixView<const int> matrix, FastWriter& out, WorkStealingPool& pool)
+{
+    out << "\nSpiral Order Output:\n";
+    const size_t SLICE = 1 << 20;
+    size_t total = matrix.size(), slices = (total + SLICE - 1) / SLICE;
+    size_t window = 4 * pool.size();
+    vector<string> results(window);
+    vector<char> ready(window, 0);
+    mutex m;
+    condition_variable done;
+    auto launch = [&](size_t t)
+    {
+        pool.submit([&, t]
+        {
+            string text = formatSpiralSlice(matrix, t * SLICE, min(total, (t + 1) * SLICE));
+            lock_guard<mutex> lock(m);
+            results[t % window].swap(text);
+            ready[t % window] = 1;
+            done.notify_all();
+        });
+    };
+    size_t nextLaunch = 0;
+    while (nextLaunch < slices && nextLaunch < window) launch(nextLaunch++);
+    for (size_t t = 0; t < slices; t++)
+    {
+        string text;
+        {
+            unique_lock<mutex> lock(m);
+            done.wait(lock, [&] { return ready[t % window] != 0; });
+            text.swap(results[t % window]);
+            ready[t % window] = 0;
         }
-        // Moving bottom --> top (if still in boundary)
-        if (left <= right) 
+        out << text;
+        if (nextLaunch < slices) launch(nextLaunch++);
+    }
+    pool.wait();
+    out << '\n';
+}
+
+// One group of layers at a time is gathered into a small buffer and
+// formatted from there
+void printSpiral(MatrixView<const int> matrix, FastWriter& out)
+{
+    out << "\nSpiral Order Output:\n";
+    size_t rows = matrix.rows(), cols = matrix.cols(), layers = spiralLayers(rows, cols);
+    Matrix<int> buffer(1, min(matrix.size(), 2 * SPIRAL_GROUP * (rows + cols)));
+    for (size_t first = 0; first < layers; first += SPIRAL_GROUP)
+    {
+        size_t last = min(layers, first + SPIRAL_GROUP);
+        spiralCopyLayers(matrix, first, last, buffer.data());
+        size_t count = (last == layers ? matrix.size() : spiralOffset(rows, cols, last)) - spiralOffset(rows, cols, first);
+        for (size_t k = 0; k < count; k++)
+            out << buffer.data()[k] << ' ';
+    }
+    out << '\n';
+}
+
+// --bench rows cols times the spiral on a generated matrix: the original
+// boundary loop, the run copy, and the text output to /dev/null
+int runBench(int argc, char* argv[])
+{
+    size_t rows = argc > 2 ? strtoull(argv[2], nullptr, 10) : 20000;
+    size_t cols = argc > 3 ? strtoull(argv[3], nullptr, 10) : rows;
+    Matrix<int> matrix(rows, cols);
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < cols; j++)
+            matrix[i][j] = (int)(i * cols + j);
+    MatrixView<const int> input = view(matrix);
+    Matrix<int> spiral(1, rows * cols);
+    auto time = [&](const char* label, auto body)
+    {
+        auto start = chrono::steady_clock::now();
+        body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cerr << label << ": " << seconds * 1000 << " ms" << endl;
+    };
+    time("element loop ", [&]
+    {
+        int* dest = spiral.data();
+        long long top = 0, bottom = rows - 1, left = 0, right = cols - 1;
+        while (top <= bottom && left <= right)
         {
-            for (int i = bottom; i >= top; i--)
-                cout << matrix[i][left] << " ";
-            left++;
+            for (long long i = left; i <= right; i++) *dest++ = matrix[top][i];
+            top++;
+            for (long long i = top; i <= bottom; i++) *dest++ = matrix[i][right];
+            right--;
+            if (top <= bottom)
+            {
+                for (long long i = right; i >= left; i--) *dest++ = matrix[bottom][i];
+                bottom--;
+            }
+            if (left <= right)
+            {
+                for (long long i = bottom; i >= top; i--) *dest++ = matrix[i][left];
+                left++;
+            }
         }
+    });
+    auto checksum = [&]
+    {
+        unsigned long long sum = 0;
+        for (size_t k = 0; k < rows * cols; k++) sum = sum * 31 + spiral.data()[k];
+        return sum;
+    };
+    unsigned long long check = checksum();
+    time("run copy     ", [&] { spiralCopy(input, spiral.data()); });
+    if (check != checksum()) cerr << "spiral mismatch" << endl;
+    int devNull = open("/dev/null", O_WRONLY);
+    time("text output  ", [&]
+    {
+        FastWriter out(devNull, 1 << 20);
+        printSpiral(input, out);
+    });
+    close(devNull);
+    return 0;
+}
+
+// --parallel rows cols [threads] checks spiralCell / spiralIndex and the
+// lazy range against the blocked copy, then times the parallel copy and
+// text output against the single-threaded ones
+int runParallel(int argc, char* argv[])
+{
+    size_t rows = argc > 2 ? strtoull(argv[2], nullptr, 10) : 10000;
+    size_t cols = argc > 3 ? strtoull(argv[3], nullptr, 10) : rows;
+    WorkStealingPool pool(argc > 4 ? atoi(argv[4]) : 0);
+    Matrix<int> matrix(rows, cols);
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < cols; j++)
+            matrix[i][j] = (int)(i * cols + j);
+    MatrixView<const int> input = view(matrix);
+    Matrix<int> spiral(1, matrix.size()), parallel(1, matrix.size());
+    spiralCopy(input, spiral.data());
+
+    size_t errors = 0;
+    uint64_t seed = 88172645463325252ull;
+    for (int q = 0; q < 100000 && matrix.size() > 0; q++)
+    {
+        seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+        size_t k = seed % matrix.size();
+        SpiralCell cell = spiralCell(rows, cols, k);
+        if (matrix[cell.row][cell.col] != spiral.data()[k] || spiralIndex(rows, cols, cell.row, cell.col) != k) errors++;
     }
-    cout << endl;
+    size_t first = matrix.size() / 3, last = min(matrix.size(), first + 100000), k = first;
+    for (const SpiralCell& cell : SpiralRange(rows, cols, first, last))
+        if (matrix[cell.row][cell.col] != spiral.data()[k++]) errors++;
+
+    auto time = [&](const char* label, auto body)
+    {
+        auto start = chrono::steady_clock::now();
+        body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cerr << label << ": " << seconds * 1000 << " ms" << endl;
+    };
+    parallelSpiralCopy(input, parallel.data(), pool);  // also faults the pages in before timing
+    if (memcmp(spiral.data(), parallel.data(), matrix.size() * sizeof(int)) != 0) errors++;
+    time("copy, 1 thread   ", [&] { spiralCopy(input, spiral.data()); });
+    time("copy, pool       ", [&] { parallelSpiralCopy(input, parallel.data(), pool); });
+    int devNull = open("/dev/null", O_WRONLY);
+    time("text, 1 thread   ", [&]
+    {
+        FastWriter out(devNull, 1 << 20);
+        printSpiral(input, out);
+    });
+    time("text, pool       ", [&]
+    {
+        FastWriter out(devNull, 1 << 20);
+        printSpiralParallel(input, out, pool);
+    });
+    close(devNull);
+    cerr << pool.size() << " threads, " << errors << " errors" << endl;
+    return errors == 0 ? 0 : 1;
 }
-int main() 
+
+int main(int argc, char* argv[])
 {
-    int n;
-    cout << "Enter the matrix size (n x n): "; //should be a square matrix
-    cin >> n;
-    int matrix[100][100];  // Assuming max size is 100x100
+    if (argc > 1 && string(argv[1]) == "--bench") return runBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--parallel") return runParallel(argc, argv);
+
+    // --in file maps a binary matrix file (see A1_matrix.h) instead of
+    // reading text, and --out file writes the spiral as a 1 x N matrix
+    // file instead of printing it. --rotate D and --transpose (in the
+    // order given) look at the matrix through a turned view; no cell is
+    // moved.
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+    vector<int> turns;  // degrees, -1 for a transpose
+    for (int k = 1; k < argc; k++)
+    {
+        string flag = argv[k];
+        if (flag == "--in" && k + 1 < argc) inPath = argv[++k];
+        else if (flag == "--out" && k + 1 < argc) outPath = argv[++k];
+        else if (flag == "--transpose") turns.push_back(-1);
+        else if (flag == "--rotate" && k + 1 < argc) turns.push_back(atoi(argv[++k]));
+    }
+
+    if (inPath && outPath && isSameFile(inPath, outPath))
+    {
+        cerr << outPath << ": same file as the input" << endl;
+        return 1;
+    }
+
+    FastWriter out;
+    Matrix<int> matrix;
+    unique_ptr<MappedMatrix<int>> mapped;
+    MatrixView<const int> shown = view(matrix);
+    if (inPath)
+    {
+        mapped.reset(new MappedMatrix<int>(inPath));
+        if (mapped->error())
+        {
+            cerr << inPath << ": " << mapped->error() << endl;
+            return 1;
+        }
+        shown = view(*mapped);
+    }
+    else
+    {
+        FastReader in(0, &out);
+        size_t rows = 0, cols = 0;
+        out << "Enter the matrix size (n for n x n, or rows cols): ";
+        if (!readMatrixSize(in, rows, cols))
+        {
+            cerr << "Expected the matrix size as n or as rows cols on one line" << endl;
+            return 1;
+        }
+        matrix = Matrix<int>(rows, cols);
+
+        // Taking input
+        out << "Enter matrix elements row-wise:\n";
+        for (size_t i = 0; i < rows; i++)
+        {
+            for (size_t j = 0; j < cols; j++)
+            {
+                if (!in.readInt(matrix[i][j]))
+                {
+                    cerr << "Bad or missing element " << i << " " << j << endl;
+                    return 1;
+                }
+            }
+        }
+        shown = view(matrix);
+    }
+    for (int turn : turns)
+        shown = turn < 0 ? shown.transposed() : shown.rotated(turn);
 
-    // Taking input
-    cout << "Enter matrix elements row-wise:\n";
-    for (int i = 0; i < n; i++) 
+    if (outPath)
     {
-        for (int j = 0; j < n; j++) 
+        MappedMatrix<int> spiral(outPath, 1, shown.size());
+        if (spiral.error())
         {
-            cin >> matrix[i][j];
+            cerr << outPath << ": " << spiral.error() << endl;
+            return 1;
         }
+        spiralCopy(shown, spiral.data());
+        return 0;
     }
-    displayMatrix(matrix, n);
-    printSpiral(matrix, n);
+    displayMatrix(shown, out);
+    printSpiral(shown, out);
     return 0; //b_s
 }
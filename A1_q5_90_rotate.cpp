@@ -1,15 +1,30 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <memory>
+#include "A1_fast_io.h"
+#include "A1_matrix.h"
+#include "A1_thread_pool.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define A1_X86_SIMD 1
+#endif
 using namespace std;
 
-void rotate90Clockwise(int matrix[][10], int N) 
+// The original layer by layer rotation, kept as the benchmark baseline
+void rotate90Clockwise(Matrix<int>& matrix)
 {
+    int N = (int)matrix.rows();
     // Rotating layer by layer
-    for (int layer = 0; layer < N / 2; layer++) 
+    for (int layer = 0; layer < N / 2; layer++)
     {
         int first = layer;
         int last = N - 1 - layer;
 
-        for (int i = first; i < last; i++) 
+        for (int i = first; i < last; i++)
         {
             int offset = i - first;
             //cyclic swaps
@@ -22,35 +37,523 @@ void rotate90Clockwise(int matrix[][10], int N)
     }
 }
 
-void printMatrix(int matrix[][10], int N) 
+// 8x8 tiles are transposed in registers; the rotations only differ in
+// the order rows are loaded and stored, so every kernel takes the row
+// step of its source and destination (negative steps walk upwards)
+const size_t TILE = 8;
+
+#ifdef A1_X86_SIMD
+__attribute__((target("avx2"))) static inline void transpose8x8(__m256i r[8])
+{
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]), t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]), t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]), t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]), t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i s0 = _mm256_unpacklo_epi64(t0, t2), s1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i s2 = _mm256_unpacklo_epi64(t1, t3), s3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i s4 = _mm256_unpacklo_epi64(t4, t6), s5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i s6 = _mm256_unpacklo_epi64(t5, t7), s7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(s0, s4, 0x20);
+    r[1] = _mm256_permute2x128_si256(s1, s5, 0x20);
+    r[2] = _mm256_permute2x128_si256(s2, s6, 0x20);
+    r[3] = _mm256_permute2x128_si256(s3, s7, 0x20);
+    r[4] = _mm256_permute2x128_si256(s0, s4, 0x31);
+    r[5] = _mm256_permute2x128_si256(s1, s5, 0x31);
+    r[6] = _mm256_permute2x128_si256(s2, s6, 0x31);
+    r[7] = _mm256_permute2x128_si256(s3, s7, 0x31);
+}
+
+// dst row b = column b of the tile whose row a is at src + a * srcStep
+__attribute__((target("avx2"))) static void transposeTileAvx2(const int* src, ptrdiff_t srcStep, int* dst, ptrdiff_t dstStep)
+{
+    __m256i r[8];
+    for (int a = 0; a < 8; a++) r[a] = _mm256_loadu_si256((const __m256i*)(src + a * srcStep));
+    transpose8x8(r);
+    for (int b = 0; b < 8; b++) _mm256_storeu_si256((__m256i*)(dst + b * dstStep), r[b]);
+}
+
+// Loads the tile at p turned a quarter clockwise (rows bottom-up, then
+// transposed) or counter-clockwise (transposed, then rows bottom-up)
+__attribute__((target("avx2"))) static inline void loadTurned(const int* p, ptrdiff_t stride, bool clockwise, __m256i r[8])
+{
+    for (int a = 0; a < 8; a++) r[a] = _mm256_loadu_si256((const __m256i*)(p + (clockwise ? 7 - a : a) * stride));
+    transpose8x8(r);
+    if (!clockwise)
+        for (int b = 0; b < 4; b++) swap(r[b], r[7 - b]);
+}
+
+// One 4-cycle of tiles: each of the four is loaded turned and stored at
+// the next corner
+__attribute__((target("avx2"))) static void cycleTilesAvx2(int* corner[4], ptrdiff_t stride, bool clockwise)
+{
+    __m256i t[4][8];
+    for (int c = 0; c < 4; c++) loadTurned(corner[c], stride, clockwise, t[c]);
+    for (int c = 0; c < 4; c++)
+    {
+        int* dst = corner[clockwise ? (c + 1) % 4 : (c + 3) % 4];
+        for (int b = 0; b < 8; b++) _mm256_storeu_si256((__m256i*)(dst + b * stride), t[c][b]);
+    }
+}
+
+__attribute__((target("avx2"))) static void reverseRowAvx2(int* row, size_t n)
+{
+    const __m256i backwards = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    size_t i = 0, j = n;
+    for (; j - i >= 16; i += 8, j -= 8)
+    {
+        __m256i front = _mm256_loadu_si256((const __m256i*)(row + i));
+        __m256i back = _mm256_loadu_si256((const __m256i*)(row + j - 8));
+        _mm256_storeu_si256((__m256i*)(row + i), _mm256_permutevar8x32_epi32(back, backwards));
+        _mm256_storeu_si256((__m256i*)(row + j - 8), _mm256_permutevar8x32_epi32(front, backwards));
+    }
+    reverse(row + i, row + j);
+}
+#endif
+
+#ifdef A1_X86_SIMD
+static bool hasAvx2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif
+
+static void transposeTile(const int* src, ptrdiff_t srcStep, int* dst, ptrdiff_t dstStep)
+{
+#ifdef A1_X86_SIMD
+    if (hasAvx2()) return transposeTileAvx2(src, srcStep, dst, dstStep);
+#endif
+    for (ptrdiff_t a = 0; a < (ptrdiff_t)TILE; a++)
+        for (ptrdiff_t b = 0; b < (ptrdiff_t)TILE; b++)
+            dst[b * dstStep + a] = src[a * srcStep + b];
+}
+
+void reverseRow(int* row, size_t n)
+{
+#ifdef A1_X86_SIMD
+    if (hasAvx2()) return reverseRowAvx2(row, n);
+#endif
+    reverse(row, row + n);
+}
+
+// The original cyclic swap, for the cell (i, j) of the top-left quadrant
+// and the three cells it trades places with
+static void cycleCells(Matrix<int>& matrix, size_t i, size_t j, bool clockwise)
+{
+    size_t last = matrix.rows() - 1;
+    int& top = matrix[i][j];
+    int& right = matrix[j][last - i];
+    int& bottom = matrix[last - i][last - j];
+    int& left = matrix[last - j][i];
+    int saved = top;
+    if (clockwise)
+    {
+        top = left, left = bottom, bottom = right, right = saved;
+    }
+    else
+    {
+        top = right, right = bottom, bottom = left, left = saved;
+    }
+}
+
+// Tiles per side of the blocks rotateQuadrantTiles works through: the
+// column images of a block then span 64 rows, few enough pages to stay in
+// the TLB while the block's tiles reuse them
+const size_t BLOCK_TILES = 8;
+
+// Rotates the tiles [rowBegin, rowEnd) x [colBegin, colEnd) of the
+// top-left quadrant, in tile units, together with their three images
+static void rotateQuadrantTiles(Matrix<int>& matrix, size_t rowBegin, size_t rowEnd, size_t colBegin, size_t colEnd, bool clockwise)
+{
+#ifdef A1_X86_SIMD
+    size_t last = matrix.rows() - 1;
+    ptrdiff_t stride = matrix.cols();
+#endif
+    for (size_t blockRow = rowBegin; blockRow < rowEnd; blockRow += BLOCK_TILES)
+    for (size_t blockCol = colBegin; blockCol < colEnd; blockCol += BLOCK_TILES)
+    for (size_t ti = blockRow; ti < min(rowEnd, blockRow + BLOCK_TILES); ti++)
+    for (size_t tj = blockCol; tj < min(colEnd, blockCol + BLOCK_TILES); tj++)
+    {
+        size_t i = ti * TILE, j = tj * TILE;
+#ifdef A1_X86_SIMD
+        if (hasAvx2())
+        {
+            int* corner[4] = {&matrix[i][j], &matrix[j][last - i - 7], &matrix[last - i - 7][last - j - 7], &matrix[last - j - 7][i]};
+            cycleTilesAvx2(corner, stride, clockwise);
+            continue;
+        }
+#endif
+        for (size_t a = i; a < i + TILE; a++)
+            for (size_t b = j; b < j + TILE; b++)
+                cycleCells(matrix, a, b, clockwise);
+    }
+}
+
+// Rows per task of the parallel rotations, one block of tiles
+const size_t BAND = BLOCK_TILES * TILE;
+
+// Quarter turn of quadrant rows [first, last): their whole tiles and then
+// the cells past the last whole tile, with all their images
+static void quarterTurnRows(Matrix<int>& matrix, size_t first, size_t last, bool clockwise)
+{
+    size_t n = matrix.rows(), height = n / 2, width = (n + 1) / 2;
+    size_t tileRows = height / TILE, tileCols = width / TILE;
+    rotateQuadrantTiles(matrix, min(first / TILE, tileRows), min(last / TILE, tileRows), 0, tileCols, clockwise);
+    for (size_t i = first; i < min(last, height); i++)
+        for (size_t j = i < tileRows * TILE ? tileCols * TILE : 0; j < width; j++)
+            cycleCells(matrix, i, j, clockwise);
+}
+
+// Half turn of rows [first, last) of the top half with their mirror rows
+static void halfTurnRows(Matrix<int>& matrix, size_t first, size_t last)
+{
+    size_t n = matrix.rows();
+    for (size_t i = first; i < min(last, (n + 1) / 2); i++)
+    {
+        reverseRow(matrix[i], n);
+        if (i != n - 1 - i)
+        {
+            reverseRow(matrix[n - 1 - i], n);
+            swap_ranges(matrix[i], matrix[i] + n, matrix[n - 1 - i]);
+        }
+    }
+}
+
+// Rotates a square matrix clockwise by 90, 180 or 270 degrees in place.
+// For a quarter turn the top-left quadrant [0, n/2) x [0, (n+1)/2) is cut
+// into 8x8 tiles; each tile and its three images form one 4-cycle, done in
+// registers in a single pass. Cells past the last whole tile are cycled
+// one by one.
+void rotateInPlace(Matrix<int>& matrix, int degrees)
+{
+    size_t n = matrix.rows();
+    if (degrees == 90 || degrees == 270)
+        quarterTurnRows(matrix, 0, n, degrees == 90);
+    else if (degrees == 180)
+        halfTurnRows(matrix, 0, n);
+}
+
+// rotateInPlace spread over the pool. The 4-cycles of different quadrant
+// rows (and the row pairs of a half turn) share no cells, so every band
+// of rows is an independent task.
+void parallelRotateInPlace(Matrix<int>& matrix, int degrees, WorkStealingPool& pool)
+{
+    size_t n = matrix.rows();
+    if (degrees != 90 && degrees != 180 && degrees != 270) return;
+    for (size_t first = 0; first < (n + 1) / 2; first += BAND)
+    {
+        pool.submit([&matrix, degrees, first]
+        {
+            if (degrees == 180)
+                halfTurnRows(matrix, first, first + BAND);
+            else
+                quarterTurnRows(matrix, first, first + BAND, degrees == 90);
+        });
+    }
+    pool.wait();
+}
+
+// Quarter turn of source columns [first, last) into result, which are
+// result rows [first, last) (90) or [cols - last, cols - first) (270).
+// Each source tile becomes one destination tile: loading the source rows
+// bottom-up (90) or storing the destination rows bottom-up (270) turns
+// the transpose into the rotation. Both views need contiguous rows.
+static void quarterTurnColumns(MatrixView<const int> matrix, MatrixView<int> result, size_t first, size_t last, bool clockwise)
+{
+    size_t rows = matrix.rows(), cols = matrix.cols();
+    // where matrix(i, j) goes
+    auto target = [&](size_t i, size_t j) -> int& { return clockwise ? result(j, rows - 1 - i) : result(cols - 1 - j, i); };
+    size_t fullRows = rows / TILE * TILE, fullCols = cols / TILE * TILE, tileEnd = min(last, fullCols);
+    ptrdiff_t srcStride = matrix.rowStride(), dstStride = result.rowStride();
+    for (size_t block = 0; block < fullRows; block += BAND)
+    {
+        for (size_t j = first; j < tileEnd; j += TILE)
+        {
+            for (size_t i = block; i < min(fullRows, block + BAND); i += TILE)
+            {
+                if (clockwise)
+                    transposeTile(&matrix(i + TILE - 1, j), -srcStride, &target(i + TILE - 1, j), dstStride);
+                else
+                    transposeTile(&matrix(i, j), srcStride, &target(i, j), -dstStride);
+            }
+        }
+    }
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = i < fullRows ? max(first, tileEnd) : first; j < last; j++)
+            target(i, j) = matrix(i, j);
+}
+
+// Source rows [first, last) copied (0) or turned (180) into result
+static void copyRows(MatrixView<const int> matrix, MatrixView<int> result, size_t first, size_t last, int degrees)
 {
-    for (int i = 0; i < N; i++) 
+    size_t rows = matrix.rows(), cols = matrix.cols();
+    for (size_t i = first; i < min(last, rows) && cols > 0; i++)
     {
-        for (int j = 0; j < N; j++) 
+        int* dst = &result(degrees == 0 ? i : rows - 1 - i, 0);
+        memcpy(dst, &matrix(i, 0), cols * sizeof(int));
+        if (degrees == 180) reverseRow(dst, cols);
+    }
+}
+
+// Writes matrix turned by degrees into result, which has the turned shape
+// and may be any memory, a mapped matrix file for one. Strided views take
+// the plain blocked copy.
+void rotateInto(MatrixView<const int> matrix, MatrixView<int> result, int degrees)
+{
+    if (matrix.colStride() != 1 || result.colStride() != 1)
+    {
+        MatrixView<const int> turned = matrix.rotated(degrees);
+        for (size_t i = 0; i < turned.rows(); i++)
+            for (size_t j = 0; j < turned.cols(); j++)
+                result(i, j) = turned(i, j);
+    }
+    else if (degrees == 0 || degrees == 180)
+        copyRows(matrix, result, 0, matrix.rows(), degrees);
+    else
+        quarterTurnColumns(matrix, result, 0, matrix.cols(), degrees == 90);
+}
+
+// Rotated copy of any rows x cols matrix
+Matrix<int> rotated(const Matrix<int>& matrix, int degrees)
+{
+    bool quarter = degrees == 90 || degrees == 270;
+    Matrix<int> result(quarter ? matrix.cols() : matrix.rows(), quarter ? matrix.rows() : matrix.cols());
+    rotateInto(view(matrix), view(result), degrees);
+    return result;
+}
+
+// rotated() spread over the pool, one task per band of destination rows.
+// The result is left untouched until then, so each page is first written,
+// and on NUMA systems placed, by the thread that fills it.
+Matrix<int> parallelRotated(const Matrix<int>& matrix, int degrees, WorkStealingPool& pool)
+{
+    bool quarter = degrees == 90 || degrees == 270;
+    Matrix<int> result(quarter ? matrix.cols() : matrix.rows(), quarter ? matrix.rows() : matrix.cols());
+    size_t bands = quarter ? matrix.cols() : matrix.rows();
+    for (size_t first = 0; first < bands; first += BAND)
+    {
+        size_t last = min(bands, first + BAND);
+        pool.submit([&matrix, &result, degrees, quarter, first, last]
+        {
+            if (quarter)
+                quarterTurnColumns(view(matrix), view(result), first, last, degrees == 90);
+            else
+                copyRows(view(matrix), view(result), first, last, degrees);
+        });
+    }
+    pool.wait();
+    return result;
+}
+
+// A rows x cols matrix whose pages are first touched by the pool, in the
+// same row bands the rotations hand out
+Matrix<int> firstTouched(size_t rows, size_t cols, WorkStealingPool& pool)
+{
+    Matrix<int> matrix(rows, cols);
+    for (size_t first = 0; first < rows; first += BAND)
+    {
+        pool.submit([&matrix, first]
+        {
+            size_t last = min(matrix.rows(), first + BAND);
+            memset(matrix[first], 0, (last - first) * matrix.cols() * sizeof(int));
+        });
+    }
+    pool.wait();
+    return matrix;
+}
+
+void printMatrix(MatrixView<const int> matrix, FastWriter& out)
+{
+    for (size_t i = 0; i < matrix.rows(); i++)
+    {
+        for (size_t j = 0; j < matrix.cols(); j++)
         {
-            cout << matrix[i][j] << " ";
+            out << matrix(i, j) << " ";
         }
-        cout << endl;
+        out << '\n';
+    }
+}
+
+// --bench [maxN] rotates N x N matrices for N = 512, 1024, ... maxN with
+// the layered loop and with the tiled engine, and checks they agree
+int runBench(int argc, char* argv[])
+{
+    size_t maxN = argc > 2 ? strtoull(argv[2], nullptr, 10) : 8192;
+    for (size_t n = 512; n <= maxN; n *= 2)
+    {
+        Matrix<int> layered(n, n), tiled(n, n);
+        for (size_t k = 0; k < n * n; k++) layered.data()[k] = tiled.data()[k] = (int)k;
+        auto time = [](auto body)
+        {
+            auto start = chrono::steady_clock::now();
+            body();
+            return chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000;
+        };
+        double slow = time([&] { rotate90Clockwise(layered); });
+        double fast = time([&] { rotateInPlace(tiled, 90); });
+        double half = time([&] { rotateInPlace(tiled, 180); });
+        rotateInPlace(tiled, 180);
+        bool same = memcmp(layered.data(), tiled.data(), n * n * sizeof(int)) == 0;
+        cout << "N = " << n << ": layered " << slow << " ms, tiled " << fast << " ms (x" << slow / fast
+             << "), 180 " << half << " ms" << (same ? "" : "  MISMATCH") << endl;
+        if (!same) return 1;
     }
+    return 0;
 }
-int main() {
-    int N;
-    cout << "Enter matrix size <=10(N x N): ";
-    cin >> N;
 
-    int matrix[10][10]; 
-    cout << "Enter the matrix elements:\n";
-    for (int i = 0; i < N; i++) 
+// --bench-threads [N] [maxThreads] times the in-place and out-of-place
+// quarter turn of an N x N matrix on 1, 2, 4 ... maxThreads threads
+int runThreadBench(int argc, char* argv[])
+{
+    size_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 8192;
+    unsigned maxThreads = argc > 3 ? atoi(argv[3]) : max(1u, thread::hardware_concurrency());
+    Matrix<int> expected;
+    for (unsigned threads = 1; threads <= maxThreads; threads = threads * 2 > maxThreads && threads < maxThreads ? maxThreads : threads * 2)
     {
-        for (int j = 0; j < N; j++) 
+        WorkStealingPool pool(threads);
+        Matrix<int> matrix = firstTouched(n, n, pool);
+        for (size_t k = 0; k < n * n; k++) matrix.data()[k] = (int)k;
+        if (threads == 1) expected = rotated(matrix, 90);
+        auto start = chrono::steady_clock::now();
+        Matrix<int> copy = parallelRotated(matrix, 90, pool);
+        double outOfPlace = chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000;
+        start = chrono::steady_clock::now();
+        parallelRotateInPlace(matrix, 90, pool);
+        double inPlace = chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000;
+        bool same = memcmp(matrix.data(), expected.data(), n * n * sizeof(int)) == 0 &&
+                    memcmp(copy.data(), expected.data(), n * n * sizeof(int)) == 0;
+        cout << threads << " threads: in place " << inPlace << " ms, out of place " << outOfPlace << " ms"
+             << (same ? "" : "  MISMATCH") << endl;
+        if (!same) return 1;
+    }
+    return 0;
+}
+
+// --bench-views [N] runs rotate 90, rotate 90, transpose, take the top
+// left quarter on an N x N matrix: once by rewriting the matrix at each
+// step, once through a view that is materialized at the end
+int runViewBench(int argc, char* argv[])
+{
+    size_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 8192;
+    Matrix<int> matrix(n, n);
+    for (size_t k = 0; k < n * n; k++) matrix.data()[k] = (int)k;
+    auto start = chrono::steady_clock::now();
+    Matrix<int> work = rotated(matrix, 90);
+    rotateInPlace(work, 90);
+    work = view(work).transposed().materialize();
+    Matrix<int> eager = view(work).block(0, 0, n / 2, n / 2).materialize();
+    double rewriting = chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000;
+    work = Matrix<int>();
+    start = chrono::steady_clock::now();
+    MatrixView<const int> lazy = view(matrix).rotated(90).rotated(90).transposed().block(0, 0, n / 2, n / 2);
+    double composing = chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000;
+    Matrix<int> result = lazy.materialize();
+    double viewing = chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000;
+    bool same = memcmp(eager.data(), result.data(), eager.size() * sizeof(int)) == 0;
+    cout << "N = " << n << ": rewriting " << rewriting << " ms, view " << composing << " ms + materialize "
+         << viewing - composing << " ms" << (same ? "" : "  MISMATCH") << endl;
+    return same ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && string(argv[1]) == "--bench") return runBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-threads") return runThreadBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-views") return runViewBench(argc, argv);
+    // --degrees D rotates clockwise by 90, 180 or 270 instead of 90.
+    // --in file maps a binary matrix file (see A1_matrix.h) instead of
+    // reading text, and --out file writes the rotated matrix to a matrix
+    // file instead of printing it.
+    int degrees = 90;
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+    for (int k = 1; k < argc; k++)
+    {
+        string flag = argv[k];
+        if (flag == "--degrees" && k + 1 < argc) degrees = atoi(argv[++k]);
+        else if (flag == "--in" && k + 1 < argc) inPath = argv[++k];
+        else if (flag == "--out" && k + 1 < argc) outPath = argv[++k];
+    }
+    degrees = (degrees % 360 + 360) % 360;
+    if (degrees % 90 != 0)
+    {
+        cerr << "Rotation must be a multiple of 90 degrees" << endl;
+        return 1;
+    }
+    if (inPath && outPath && isSameFile(inPath, outPath))
+    {
+        cerr << outPath << ": same file as the input" << endl;
+        return 1;
+    }
+
+    FastWriter out;
+    Matrix<int> matrix;
+    unique_ptr<MappedMatrix<int>> mapped;
+    MatrixView<const int> input = view(matrix);
+    if (inPath)
+    {
+        mapped.reset(new MappedMatrix<int>(inPath));
+        if (mapped->error())
+        {
+            cerr << inPath << ": " << mapped->error() << endl;
+            return 1;
+        }
+        input = view(*mapped);
+    }
+    else
+    {
+        FastReader in(0, &out);
+        size_t rows = 0, cols = 0;
+        out << "Enter matrix size (N for N x N, or rows cols): ";
+        if (!readMatrixSize(in, rows, cols))
+        {
+            cerr << "Expected the matrix size as N or as rows cols on one line" << endl;
+            return 1;
+        }
+
+        matrix = Matrix<int>(rows, cols);
+        out << "Enter the matrix elements:\n";
+        for (size_t i = 0; i < rows; i++)
+        {
+            for (size_t j = 0; j < cols; j++)
+            {
+                if (!in.readInt(matrix[i][j]))
+                {
+                    cerr << "Bad or missing element " << i << " " << j << endl;
+                    return 1;
+                }
+            }
+        }
+        input = view(matrix);
+    }
+
+    if (outPath)
+    {
+        // the engine writes straight into the pages of the new file
+        bool quarter = degrees == 90 || degrees == 270;
+        MappedMatrix<int> result(outPath, quarter ? input.cols() : input.rows(), quarter ? input.rows() : input.cols());
+        if (result.error())
         {
-            cin >> matrix[i][j];
+            cerr << outPath << ": " << result.error() << endl;
+            return 1;
         }
+        rotateInto(input, view(result), degrees);
+        return 0;
+    }
+    out << "\nOriginal Matrix:\n";
+    printMatrix(input, out);
+    // a typed-in square matrix is turned in place as before; a mapped or
+    // non-square one is turned into a new matrix of the turned shape
+    out << "\nRotated Matrix:\n";
+    if (!mapped && matrix.rows() == matrix.cols())
+    {
+        rotateInPlace(matrix, degrees);
+        printMatrix(view(matrix), out);
+        return 0;
     }
-    cout << "\nOriginal Matrix:\n";
-    printMatrix(matrix, N);
-    rotate90Clockwise(matrix, N);
-    cout << "\nRotated Matrix:\n";
-    printMatrix(matrix, N);
+    bool quarter = degrees == 90 || degrees == 270;
+    Matrix<int> result(quarter ? input.cols() : input.rows(), quarter ? input.rows() : input.cols());
+    rotateInto(input, view(result), degrees);
+    printMatrix(view(result), out);
     return 0; //b_s
 }
@@ -0,0 +1,150 @@
+#ifndef A1_THREAD_POOL_H
+#define A1_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool where every worker owns a task deque. A worker pops its own
+// newest task first and, once its deque is empty, steals the oldest task of
+// another worker, so uneven tasks still keep all cores busy.
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(unsigned threads = 0)
+        : queued(0), pending(0), nextQueue(0), stopping(false)
+    {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; i++) queues.emplace_back(new TaskQueue);
+        for (unsigned i = 0; i < threads; i++) workers.emplace_back([this, i] { run(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // Index of the calling worker in [0, size()), or -1 outside the pool
+    int workerIndex() const { return current().pool == this ? (int)current().index : -1; }
+
+    // Tasks submitted from a worker go to its own deque, others round-robin
+    void submit(std::function<void()> task)
+    {
+        int self = workerIndex();
+        unsigned target = self >= 0 ? (unsigned)self : nextQueue++ % size();
+        pending++;
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->m);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        wake.notify_one();
+    }
+
+    // Blocks until every submitted task has finished
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        idle.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    struct TaskQueue
+    {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+    struct Current
+    {
+        const WorkStealingPool* pool;
+        unsigned index;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake, idle;
+    size_t queued;                 // tasks sitting in deques, guarded by sleepMutex
+    std::atomic<size_t> pending;   // submitted but not yet finished
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+
+    static Current& current()
+    {
+        thread_local Current c = {nullptr, 0};
+        return c;
+    }
+
+    bool take(unsigned self, std::function<void()>& task)
+    {
+        {
+            TaskQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.m);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (unsigned k = 1; k < queues.size(); k++)
+        {
+            TaskQueue& victim = *queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(unsigned self)
+    {
+        current() = {this, self};
+        while (true)
+        {
+            std::function<void()> task;
+            if (take(self, task))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    queued--;
+                }
+                task();
+                if (--pending == 0)
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    idle.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping && queued == 0) return;
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+        }
+    }
+};
+
+#endif
@@ -1,32 +1,70 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <fstream>
+#include <map>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include "UMS_report_writer.h"
 using namespace std;
 
 // Base class Person
 class Person 
 {
 public:
-    virtual void displayDetails() = 0;  // (virtual function) for polymorphism
+    virtual void displayDetails(ReportWriter& out) = 0;  // (virtual function) for polymorphism
     virtual ~Person() {}
 };
 
+// Course names interned to dense ids 0, 1, 2 ... in order of first use,
+// so a student's courses are a set of small integers
+class CourseTable
+{
+private:
+    unordered_map<string, int> ids;
+    vector<string> names;
+
+public:
+    int intern(const string& name) {
+        auto it = ids.emplace(name, (int)names.size()).first;
+        if (it->second == (int)names.size()) names.push_back(name);
+        return it->second;
+    }
+
+    // -1 for a name no student has taken
+    int find(const string& name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    const string& name(int id) const { return names[id]; }
+    int size() const { return (int)names.size(); }
+};
+
+CourseTable courseTable;  // shared by every Student
+
 class Student : public Person
 {
 private:
     string name;
     int rollNumber;
     float cgpa;
-    string courses[10];
-    int courseCount;
+    // Course ids as a bitset: ids 0..63 in courseBits, id 64 * (k + 1) + b
+    // as bit b of moreCourses[k], which stays empty for most students
+    uint64_t courseBits;
+    vector<uint64_t> moreCourses;
 
 public:
-    Student() : name(""), rollNumber(0), cgpa(0.0), courseCount(0) {}  // Default constructor
+    Student() : name(""), rollNumber(0), cgpa(0.0), courseBits(0) {}  // Default constructor
     Student(string n, int roll, float c) 
     {
         name = n;
         rollNumber = roll;
         cgpa = (c >= 0.0 && c <= 10.0) ? c : 0.0;
-        courseCount = 0;
+        courseBits = 0;
     }
     string getName() { return name; }
     void setName(string n) { name = n; }
@@ -39,59 +77,193 @@ public:
 
     void addCourse(string course) 
     {
-        for (int i = 0; i < courseCount; ++i) {
-            if (courses[i] == course) return;
+        int id = courseTable.intern(course);
+        if (id < 64) {
+            courseBits |= 1ull << id;
+            return;
         }
-        if (courseCount < 10) courses[courseCount++] = course;
+        size_t word = id / 64 - 1;
+        if (moreCourses.size() <= word) moreCourses.resize(word + 1, 0);
+        moreCourses[word] |= 1ull << (id % 64);
     }
 
-    void displayDetails() override 
+    bool hasCourse(int id) const {
+        if (id < 0) return false;
+        if (id < 64) return (courseBits >> id) & 1;
+        size_t word = id / 64 - 1;
+        return word < moreCourses.size() && ((moreCourses[word] >> (id % 64)) & 1);
+    }
+
+    bool hasCourse(const string& course) const { return hasCourse(courseTable.find(course)); }
+
+    int courseCount() const {
+        int count = __builtin_popcountll(courseBits);
+        for (uint64_t bits : moreCourses) count += __builtin_popcountll(bits);
+        return count;
+    }
+
+    // Calls f(id) for each course, in id order
+    template <class F>
+    void forEachCourse(F f) const {
+        for (size_t word = 0; word <= moreCourses.size(); ++word) {
+            uint64_t bits = word == 0 ? courseBits : moreCourses[word - 1];
+            for (; bits; bits &= bits - 1) f((int)(64 * word + __builtin_ctzll(bits)));
+        }
+    }
+
+    void displayDetails(ReportWriter& out) override 
     {
-        cout << "Name: " << name << endl;
-        cout << "Roll Number: " << rollNumber << endl;
-        cout << "CGPA: " << cgpa << endl;
-        cout << "Courses: ";
-        for (int i = 0; i < courseCount; ++i) cout << courses[i] << " ";
-        cout << endl;
+        out << "Name: " << name << '\n';
+        out << "Roll Number: " << rollNumber << '\n';
+        out << "CGPA: " << cgpa << '\n';
+        out << "Courses: ";
+        forEachCourse([&out](int id) { out << courseTable.name(id) << ' '; });
+        out << '\n';
+    }
+};
+
+// Open-addressing table from roll number to a slot in some array, kept
+// at most half full
+class RollIndex
+{
+private:
+    vector<int> keys;      // roll number in each table slot
+    vector<int> slots;     // the value, -1 for an empty slot
+    int shift;             // 64 - log2(table size)
+    size_t used;
+
+public:
+    RollIndex() : keys(16), slots(16, -1), shift(60), used(0) {}
+
+    // Room for n roll numbers in all without rebuilding the table
+    void reserve(size_t n) {
+        if (2 * n > slots.size()) rehash(2 * n);
+    }
+
+    // Slot of roll, -1 when it is not in the table
+    int get(int roll) const { return slots[find(roll)]; }
+
+    // False, and nothing changed, when roll is already in the table
+    bool insert(int roll, int slot) {
+        size_t i = find(roll);
+        if (slots[i] >= 0) return false;
+        if (2 * (used + 1) > slots.size()) {
+            rehash(2 * slots.size());
+            i = find(roll);
+        }
+        keys[i] = roll;
+        slots[i] = slot;
+        used++;
+        return true;
+    }
+
+private:
+    // Slot holding roll, or the empty slot where it would go. The slot
+    // comes from the top bits of a multiplicative hash, so roll numbers
+    // that share their low bits (all multiples of 100, say) still spread.
+    size_t find(int roll) const {
+        size_t mask = slots.size() - 1;
+        size_t i = ((uint32_t)roll * 0x9E3779B97F4A7C15ull) >> shift;
+        while (slots[i] >= 0 && keys[i] != roll) i = (i + 1) & mask;
+        return i;
+    }
+
+    // Table of at least n slots (a power of two) holding the same entries
+    void rehash(size_t n) {
+        size_t size = 16;
+        int bits = 60;
+        while (size < n) size *= 2, bits--;
+        vector<int> oldKeys(size, 0), oldSlots(size, -1);
+        oldKeys.swap(keys);
+        oldSlots.swap(slots);
+        shift = bits;
+        for (size_t j = 0; j < oldSlots.size(); ++j) {
+            if (oldSlots[j] < 0) continue;
+            size_t i = find(oldKeys[j]);
+            keys[i] = oldKeys[j];
+            slots[i] = oldSlots[j];
+        }
     }
 };
 
 // Class to manage student grades for a course
+// One grade per roll number, stored as two columns. The sum and a count of
+// students per distinct grade are kept up to date on every change (O(log d)
+// for d distinct grades), so the average and both extremes are O(1) reads
+// and no update ever needs a rescan.
 class GradeBook
 {
 private:
-    int studentRollNumbers[100];
-    float studentGrades[100];
-    int count;
+    vector<int> studentRollNumbers;
+    vector<float> studentGrades;
+    RollIndex index;       // roll number to position in the columns
+    double total;
+    map<float, size_t> gradeCounts;  // students per distinct grade, so the extremes are its ends
 
 public:
-    GradeBook() { count = 0; }
+    GradeBook() : total(0) {}
 
+    void reserve(size_t n) {
+        studentRollNumbers.reserve(n);
+        studentGrades.reserve(n);
+        index.reserve(n);
+    }
+
+    // Records the grade, replacing the student's earlier one if any
     void addGrade(int rollNumber, float grade) {
-        if (count < 100) {
-            studentRollNumbers[count] = rollNumber;
-            studentGrades[count] = grade;
-            count++;
+        int at = (int)studentGrades.size();
+        if (!index.insert(rollNumber, at)) {
+            updateGrade(rollNumber, grade);
+            return;
         }
+        studentRollNumbers.push_back(rollNumber);
+        studentGrades.push_back(grade);
+        total += grade;
+        gradeCounts[grade]++;
     }
 
+    // False when the student has no grade yet
+    bool updateGrade(int rollNumber, float grade) {
+        int at = index.get(rollNumber);
+        if (at < 0) return false;
+        float old = studentGrades[at];
+        studentGrades[at] = grade;
+        total += (double)grade - old;
+        auto entry = gradeCounts.find(old);
+        if (--entry->second == 0) gradeCounts.erase(entry);
+        gradeCounts[grade]++;
+        return true;
+    }
+
+    // False when the student has no grade
+    bool getGrade(int rollNumber, float& grade) {
+        int at = index.get(rollNumber);
+        if (at >= 0) grade = studentGrades[at];
+        return at >= 0;
+    }
+
+    size_t gradeCount() { return studentGrades.size(); }
+
     float calculateAverageGrade() {
-        if (count == 0) return 0.0;
-        float total = 0;
-        for (int i = 0; i < count; ++i) {
-            total += studentGrades[i];
-        }
-        return total / count;
+        if (studentGrades.empty()) return 0.0;
+        return (float)(total / studentGrades.size());
     }
 
-    void getHighestGrade() {
-        float highest = studentGrades[0];
-        for (int i = 1; i < count; ++i) {
-            if (studentGrades[i] > highest) {
-                highest = studentGrades[i];
-            }
+    // Both 0 when there are no grades
+    float highestGrade() {
+        return gradeCounts.empty() ? 0 : gradeCounts.rbegin()->first;
+    }
+
+    float lowestGrade() {
+        return gradeCounts.empty() ? 0 : gradeCounts.begin()->first;
+    }
+
+    void getHighestGrade(ReportWriter& out) {
+        if (studentGrades.empty()) {
+            out << "No grades recorded\n";
+            return;
         }
-        cout << "Highest Grade: " << highest << endl;
+        out << "Highest Grade: " << highestGrade() << '\n';
     }
 };
 
@@ -113,42 +285,229 @@ public:
         }
     }
 
-    void displayEnrollments() {
+    void displayEnrollments(ReportWriter& out) {
         for (int i = 0; i < enrollCount; ++i) {
-            cout << "Roll Number: " << studentRollNumbers[i] << " is enrolled in course " << courseCodes[i] << endl;
+            out << "Roll Number: " << studentRollNumbers[i] << " is enrolled in course " << courseCodes[i] << '\n';
         }
     }
 };
 
 // UniversityManagementSystem class 
+// Students are kept in one growable array, in the order they were added,
+// and a RollIndex maps each roll number to its slot there.
 class UniversityManagementSystem {
 private:
-    Student students[100];
-    int studentCount;
+    vector<Student> students;
+    RollIndex index;
 
 public:
-    UniversityManagementSystem() { studentCount = 0; }
+    UniversityManagementSystem() {}
+
+    // Makes room for n students in all, so a bulk load neither moves the
+    // students nor rebuilds the table on the way
+    void reserve(size_t n) {
+        students.reserve(n);
+        index.reserve(n);
+    }
+
+    // False, and nothing added, when the roll number is already taken
+    bool addStudent(Student s) {
+        if (!index.insert(s.getRollNumber(), (int)students.size())) return false;
+        students.push_back(move(s));
+        return true;
+    }
 
-    void addStudent(Student s) {
-        if (studentCount < 100) students[studentCount++] = s;
+    // Adds a batch after reserving room for all of it; returns how many
+    // were added (duplicates are skipped)
+    size_t addStudents(vector<Student> batch) {
+        reserve(students.size() + batch.size());
+        size_t added = 0;
+        for (Student& s : batch) added += addStudent(move(s));
+        return added;
     }
 
+    // The pointer is valid until the next student is added
     Student* searchStudent(int roll) {
-        for (int i = 0; i < studentCount; ++i) {
+        int slot = index.get(roll);
+        return slot >= 0 ? &students[slot] : nullptr;
+    }
+
+    // The original linear search, kept as the benchmark baseline
+    Student* scanStudents(int roll) {
+        for (size_t i = 0; i < students.size(); ++i) {
             if (students[i].getRollNumber() == roll) return &students[i];
         }
         return nullptr;
     }
 
-    void displayAll() {
-        for (int i = 0; i < studentCount; ++i) {
-            students[i].displayDetails();
-            cout << "-------------------------\n";
+    size_t studentCount() const { return students.size(); }
+
+    // Students taking the course, in the order they were added: one bit
+    // test per student against the interned id
+    vector<Student*> studentsInCourse(const string& course) {
+        vector<Student*> result;
+        int id = courseTable.find(course);
+        if (id < 0) return result;
+        for (Student& s : students) {
+            if (s.hasCourse(id)) result.push_back(&s);
+        }
+        return result;
+    }
+
+    void displayAll(ReportWriter& out) {
+        for (size_t i = 0; i < students.size(); ++i) {
+            students[i].displayDetails(out);
+            out << "-------------------------\n";
         }
     }
 };
 
-int main() {
+// --bench-lookup [students] [lookups] loads that many students in one
+// reserved batch and times random roll number lookups through the index
+// against the linear scan
+int runLookupBench(int argc, char* argv[]) {
+    size_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 300000;
+    size_t lookups = argc > 3 ? strtoull(argv[3], nullptr, 10) : 10000000;
+    vector<Student> batch;
+    batch.reserve(n);
+    uint32_t seed = 2463534242u;
+    vector<int> rolls(n);
+    for (size_t i = 0; i < n; ++i) {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        rolls[i] = (int)(seed & 0x7FFFFFFF);
+        batch.push_back(Student("S" + to_string(i), rolls[i], (float)(seed % 1000) / 100));
+    }
+    UniversityManagementSystem ums;
+    auto start = chrono::steady_clock::now();
+    size_t added = ums.addStudents(move(batch));
+    double load = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << added << " students loaded in " << load * 1000 << " ms" << endl;
+
+    auto time = [&](const char* label, size_t count, Student* (UniversityManagementSystem::*search)(int)) {
+        size_t found = 0;
+        uint32_t pick = 88675123u;
+        auto begin = chrono::steady_clock::now();
+        for (size_t q = 0; q < count; ++q) {
+            pick ^= pick << 13, pick ^= pick >> 17, pick ^= pick << 5;
+            // one lookup in eight asks for a roll number nobody has
+            int roll = pick % 8 == 0 ? -(int)(pick >> 3) - 1 : rolls[pick % n];
+            found += (ums.*search)(roll) != nullptr;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << label << ": " << count / seconds << " lookups/s (" << found << " of " << count << " found)" << endl;
+    };
+    time("hash index ", lookups, &UniversityManagementSystem::searchStudent);
+    // the scan is O(n) per lookup, so it gets a fixed amount of work
+    time("linear scan", max<size_t>(1, min(lookups, 2000000000 / max<size_t>(n, 1))), &UniversityManagementSystem::scanStudents);
+    return 0;
+}
+
+// --bench-grades [grades] [updates] fills a GradeBook with that many
+// grades, then times updates that each read the average and extremes,
+// against re-summing and rescanning the columns as the old GradeBook did
+int runGradeBench(int argc, char* argv[]) {
+    size_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 10000000;
+    size_t updates = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1000000;
+    uint32_t seed = 2463534242u;
+    auto next = [&] {
+        seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+        return seed;
+    };
+    GradeBook book;
+    book.reserve(n);
+    vector<float> grades(n);  // a plain copy for the rescanning baseline
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        grades[i] = (float)(next() % 1001) / 100;
+        book.addGrade(1000000 + (int)i, grades[i]);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << n << " grades added in " << seconds * 1000 << " ms" << endl;
+
+    double check = 0;
+    start = chrono::steady_clock::now();
+    for (size_t u = 0; u < updates && n > 0; ++u) {
+        size_t i = next() % n;
+        book.updateGrade(1000000 + (int)i, (float)(next() % 1001) / 100);
+        check += book.calculateAverageGrade() + book.highestGrade() + book.lowestGrade();
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "running aggregates: " << updates / seconds << " updates + queries/s" << endl;
+
+    // worst case for counting only the extremes: one student alone at the
+    // top is lowered and raised again, so the top keeps being taken away
+    start = chrono::steady_clock::now();
+    for (size_t u = 0; u < updates && n > 0; ++u) {
+        book.updateGrade(1000000, u % 2 ? 101.0f : 50.0f);
+        check += book.highestGrade() + book.lowestGrade();
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "top student updated: " << updates / seconds << " updates + queries/s" << endl;
+
+    // the old way is O(n) per query, so it gets a fixed amount of work
+    size_t rounds = max<size_t>(1, min(updates, 200000000 / max<size_t>(n, 1)));
+    start = chrono::steady_clock::now();
+    for (size_t u = 0; u < rounds && n > 0; ++u) {
+        grades[next() % n] = (float)(next() % 1001) / 100;
+        float total = 0, highest = grades[0], lowest = grades[0];
+        for (float grade : grades) {
+            total += grade;
+            highest = max(highest, grade);
+            lowest = min(lowest, grade);
+        }
+        check += total / n + highest + lowest;
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "rescanning        : " << rounds / seconds << " updates + queries/s (checksum " << check << ")" << endl;
+    return 0;
+}
+
+// --bench-report [students] [file] writes the displayAll report for that
+// many students the old way, with an ofstream and endl after every line,
+// to file, and through a ReportWriter to file.new; the two files match
+int runReportBench(int argc, char* argv[]) {
+    size_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    string path = argc > 3 ? argv[3] : "/tmp/OOPS_UMS_A2_report.txt";
+    UniversityManagementSystem ums;
+    ums.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        Student s("Student" + to_string(i), (int)i, (float)(i % 1001) / 100);
+        s.addCourse(i % 2 ? "Math" : "Physics");
+        s.addCourse("Chemistry");
+        ums.addStudent(move(s));
+    }
+    auto time = [](const char* label, auto body) {
+        auto start = chrono::steady_clock::now();
+        body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << label << ": " << seconds * 1000 << " ms" << endl;
+    };
+    time("ofstream + endl", [&] {
+        ofstream file(path);
+        for (size_t i = 0; i < ums.studentCount(); ++i) {
+            Student* s = ums.searchStudent((int)i);
+            file << "Name: " << s->getName() << endl;
+            file << "Roll Number: " << s->getRollNumber() << endl;
+            file << "CGPA: " << s->getCgpa() << endl;
+            file << "Courses: ";
+            s->forEachCourse([&file](int id) { file << courseTable.name(id) << " "; });
+            file << endl;
+            file << "-------------------------\n";
+        }
+    });
+    time("ReportWriter   ", [&] {
+        ReportWriter out(path + ".new");
+        ums.displayAll(out);
+    });
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench-lookup") return runLookupBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-grades") return runGradeBench(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench-report") return runReportBench(argc, argv);
+    ReportWriter out;  // the whole report goes out in one write at the end
+
     //  UniversityManagementSystem
     UniversityManagementSystem ums;
 
@@ -164,30 +523,30 @@ int main() {
     ums.addStudent(s2);
 
     // Display all students
-    ums.displayAll();
+    ums.displayAll(out);
 
     // Search for a student by roll number
     int roll = 101;
     Student* found = ums.searchStudent(roll);
     if (found) {
-        cout << "\nDetails of student with roll number " << roll << ":\n";
-        found->displayDetails();
+        out << "\nDetails of student with roll number " << roll << ":\n";
+        found->displayDetails(out);
     } else {
-        cout << "\nStudent not found.\n";
+        out << "\nStudent not found.\n";
     }
 
     // GradeBook Example
     GradeBook gradeBook;
     gradeBook.addGrade(101, 8.5);
     gradeBook.addGrade(102, 7.8);
-    gradeBook.getHighestGrade();
-    cout << "Average Grade: " << gradeBook.calculateAverageGrade() << endl;
+    gradeBook.getHighestGrade(out);
+    out << "Average Grade: " << gradeBook.calculateAverageGrade() << '\n';
 
     // EnrollmentManager Example
     EnrollmentManager enrollmentManager;
     enrollmentManager.enrollStudent(101, "CS101");
     enrollmentManager.enrollStudent(102, "Math102");
-    enrollmentManager.displayEnrollments();
+    enrollmentManager.displayEnrollments(out);
 
     return 0;
 }
@@ -3,6 +3,7 @@
 #include <vector>
 #include <stdexcept>
 #include <map>
+#include "UMS_report_writer.h"
 using namespace std;
 
 // Custom Exceptions
@@ -41,7 +42,7 @@ public:
     Person(string n, int i) : name(n), id(i) {
         if (i <= 0) throw UniversitySystemException("Invalid ID assigned.");
     }
-    virtual void displayDetails() = 0;
+    virtual void displayDetails(ReportWriter& out) = 0;
     virtual ~Person() {}
 };
 
@@ -60,8 +61,8 @@ public:
     float calculatePayment() override {
         return baseSalary + (yearsOfService * 1000);
     }
-    void displayDetails() override {
-        cout << "Assistant Professor: " << name << ", ID: " << id << ", Salary: " << calculatePayment() << endl;
+    void displayDetails(ReportWriter& out) override {
+        out << "Assistant Professor: " << name << ", ID: " << id << ", Salary: " << calculatePayment() << '\n';
     }
 };
 
@@ -71,8 +72,8 @@ public:
     float calculatePayment() override {
         return baseSalary + (yearsOfService * 1500);
     }
-    void displayDetails() override {
-        cout << "Associate Professor: " << name << ", ID: " << id << ", Salary: " << calculatePayment() << endl;
+    void displayDetails(ReportWriter& out) override {
+        out << "Associate Professor: " << name << ", ID: " << id << ", Salary: " << calculatePayment() << '\n';
     }
 };
 
@@ -82,8 +83,8 @@ public:
     float calculatePayment() override {
         return baseSalary + (yearsOfService * 2000);
     }
-    void displayDetails() override {
-        cout << "Full Professor: " << name << ", ID: " << id << ", Salary: " << calculatePayment() << endl;
+    void displayDetails(ReportWriter& out) override {
+        out << "Full Professor: " << name << ", ID: " << id << ", Salary: " << calculatePayment() << '\n';
     }
 };
 
@@ -96,8 +97,8 @@ public:
     Student(string n, int i, float c) : Person(n, i), cgpa(c) {
         if (c < 0.0 || c > 10.0) throw UniversitySystemException("Invalid CGPA.");
     }
-    virtual void displayDetails() override {
-        cout << "Student: " << name << ", ID: " << id << ", CGPA: " << cgpa << endl;
+    virtual void displayDetails(ReportWriter& out) override {
+        out << "Student: " << name << ", ID: " << id << ", CGPA: " << cgpa << '\n';
     }
 };
 
@@ -106,9 +107,9 @@ class UndergraduateStudent : public Student {
 public:
     UndergraduateStudent(string n, int i, float c, string maj, string min, string grad)
         : Student(n, i, c), major(maj), minor(min), graduationDate(grad) {}
-    void displayDetails() override {
-        Student::displayDetails();
-        cout << "Major: " << major << ", Minor: " << minor << ", Graduation: " << graduationDate << endl;
+    void displayDetails(ReportWriter& out) override {
+        Student::displayDetails(out);
+        out << "Major: " << major << ", Minor: " << minor << ", Graduation: " << graduationDate << '\n';
     }
 };
 
@@ -119,10 +120,10 @@ public:
     GraduateStudent(string n, int i, float c, string topic, string thesis, Professor* adv)
         : Student(n, i, c), researchTopic(topic), thesisTitle(thesis), advisor(adv) {}
 
-    void displayDetails() override {
-        Student::displayDetails();
-        cout << "Research Topic: " << researchTopic << ", Thesis: " << thesisTitle << endl;
-        cout << "Advisor: "; advisor->displayDetails();
+    void displayDetails(ReportWriter& out) override {
+        Student::displayDetails(out);
+        out << "Research Topic: " << researchTopic << ", Thesis: " << thesisTitle << '\n';
+        out << "Advisor: "; advisor->displayDetails(out);
     }
 };
 
@@ -140,9 +141,9 @@ public:
         enrolled.push_back(s);
     }
 
-    void displayCourse() {
-        cout << "Course: " << title << " by "; instructor->displayDetails();
-        for (Student* s : enrolled) s->displayDetails();
+    void displayCourse(ReportWriter& out) {
+        out << "Course: " << title << " by "; instructor->displayDetails(out);
+        for (Student* s : enrolled) s->displayDetails(out);
     }
 };
 
@@ -167,8 +168,8 @@ class Department {
 public:
     Department(string n) : name(n) {}
     void addProfessor(Professor* p) { professors.push_back(p); }
-    void listProfessors() {
-        for (Professor* p : professors) p->displayDetails();
+    void listProfessors(ReportWriter& out) {
+        for (Professor* p : professors) p->displayDetails(out);
     }
 };
 
@@ -190,12 +191,13 @@ public:
         }
     }
 
-    void showAll() {
-        for (auto c : courses) c->displayCourse();
+    void showAll(ReportWriter& out) {
+        for (auto c : courses) c->displayCourse(out);
     }
 };
 
 int main() {
+    ReportWriter out;  // flushed once, when main returns
     try {
         AssistantProfessor prof1("Dr. Smith", 1, 5, 50000);
         UndergraduateStudent ugs("Alice", 101, 8.5, "CSE", "Math", "2026");
@@ -210,9 +212,9 @@ int main() {
         GradeBook grades;
         grades.addGrade(ugs.getId(), 9.0);
 
-        cout << "Average grade: " << grades.calculateAverage() << endl;
+        out << "Average grade: " << grades.calculateAverage() << '\n';
 
-        uni.showAll();
+        uni.showAll(out);
 
     } catch (const UniversitySystemException& e) {
         cerr << "System Exception: " << e.what() << endl;
@@ -6,6 +6,12 @@
 #include <stdexcept>
 #include <string>
 #include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include "UMS_report_writer.h"
 
 using namespace std;
 
@@ -59,8 +65,11 @@ public:
     void setID(const string& i) { uniqueID = i; }
     void setContact(const string& c) { contactNum = c; }
 
-    virtual void displayDetails() const {
-        cout << "Name: " << name << ", Age: " << ageYears << ", ID: " << uniqueID << ", Contact: " << contactNum << endl;
+    const string& getName() const { return name; }
+    const string& getID() const { return uniqueID; }
+
+    virtual void displayDetails(ReportWriter& out) const {
+        out << "Name: " << name << ", Age: " << ageYears << ", ID: " << uniqueID << ", Contact: " << contactNum << '\n';
     }
     virtual double calculateFees() const { return 0.0; }
 };
@@ -81,9 +90,9 @@ public:
         if (gpa < 0.0 || gpa > 4.0) throw GradeProblem("GPA should be between 0.0 and 4.0.");
         currentGPA = gpa;
     }
-    void displayDetails() const override {
-        Person::displayDetails();
-        cout << "Programme: " << programme << ", GPA: " << currentGPA << ", Admitted on: " << admissionDate << endl;
+    void displayDetails(ReportWriter& out) const override {
+        Person::displayDetails(out);
+        out << "Programme: " << programme << ", GPA: " << currentGPA << ", Admitted on: " << admissionDate << '\n';
     }
 };
 
@@ -93,9 +102,9 @@ public:
     UndergradStudent(string n, int a, string i, string c, string prog, float g, string adm,
                      string major, string minor, string gradDate)
         : Student(n, a, i, c, prog, g, adm), majorSubject(major), minorSubject(minor), expectedGradDate(gradDate) {}
-    void displayDetails() const override {
-        Student::displayDetails();
-        cout << "Major: " << majorSubject << ", Minor (if any): " << minorSubject << ", Expected Graduation: " << expectedGradDate << endl;
+    void displayDetails(ReportWriter& out) const override {
+        Student::displayDetails(out);
+        out << "Major: " << majorSubject << ", Minor (if any): " << minorSubject << ", Expected Graduation: " << expectedGradDate << '\n';
     }
 };
 
@@ -105,28 +114,20 @@ public:
     GradStudent(string n, int a, string i, string c, string prog, float g, string adm,
                 string research, string guide, string thesis)
         : Student(n, a, i, c, prog, g, adm), researchArea(research), guideName(guide), thesisTitle(thesis) {}
-    void displayDetails() const override {
-        Student::displayDetails();
-        cout << "Research Area: " << researchArea << ", Guide: " << guideName << ", Thesis: " << thesisTitle << endl;
+    void displayDetails(ReportWriter& out) const override {
+        Student::displayDetails(out);
+        out << "Research Area: " << researchArea << ", Guide: " << guideName << ", Thesis: " << thesisTitle << '\n';
     }
 };
-class Professor {
-    friend class Department;  //  Use with caution
-protected:
-    string uniqueID;
-public:
-    string name;
-};
-
 class Professor : public Person {
 protected:
     string deptName, specializationArea, joiningDate;
 public:
     Professor(string n, int a, string i, string c, string dept, string spec, string joinDate)
         : Person(n, a, i, c), deptName(dept), specializationArea(spec), joiningDate(joinDate) {}
-    void displayDetails() const override {
-        Person::displayDetails();
-        cout << "Department: " << deptName << ", Specialization: " << specializationArea << endl;
+    void displayDetails(ReportWriter& out) const override {
+        Person::displayDetails(out);
+        out << "Department: " << deptName << ", Specialization: " << specializationArea << '\n';
     }
 };
 
@@ -148,10 +149,11 @@ public:
         if (credits <= 0) throw UniSystemError("Course must have at least 1 credit.");
     }
     void assignInstructor(Professor* p) { instructorInCharge = p; }
-    void displayDetails() const {
-        cout << "Course Code: " << courseCode << ", Title: " << courseTitle << ", Credits: " << creditsOffered;
-        if (instructorInCharge) cout << ", Instructor: " << instructorInCharge->name;
-        cout << endl;
+    const string& getCode() const { return courseCode; }
+    void displayDetails(ReportWriter& out) const {
+        out << "Course Code: " << courseCode << ", Title: " << courseTitle << ", Credits: " << creditsOffered;
+        if (instructorInCharge) out << ", Instructor: " << instructorInCharge->getName();
+        out << '\n';
     }
 };
 
@@ -166,15 +168,15 @@ public:
         : deptName(name), location(loc), annualBudget(budget) {}
     void addProfessor(Professor* p) { faculty.push_back(p); }
     void addCourse(const Course& c) { offeredCourses.push_back(c); }
-    void displayDetails() const {
-        cout << "Department Name: " << deptName << ", Location: " << location << ", Budget: " << annualBudget << endl;
-        cout << "Faculty: " << endl;
+    void displayDetails(ReportWriter& out) const {
+        out << "Department Name: " << deptName << ", Location: " << location << ", Budget: " << annualBudget << '\n';
+        out << "Faculty: \n";
         for (const auto& prof : faculty) {
-            cout << "- " << prof->name << " (" << prof->uniqueID << ")" << endl;
+            out << "- " << prof->getName() << " (" << prof->getID() << ")\n";
         }
-        cout << "Courses Offered: " << endl;
+        out << "Courses Offered: \n";
         for (const auto& course : offeredCourses) {
-            course.displayDetails();
+            course.displayDetails(out);
         }
     }
 };
@@ -194,96 +196,128 @@ public:
 };
 
 class EnrollmentManager {
-    map<string, vector<string>> courseWiseEnrollment;
+    unordered_map<string, vector<string>> courseWiseEnrollment;
 public:
+    // Records the pair as given; University checks it first
     void enrollStudent(const string& courseCode, const string& studentID) {
         courseWiseEnrollment[courseCode].push_back(studentID);
-        cout << "Student " << studentID << " enrolled in course " << courseCode << endl;
     }
-    void displayCourseEnrollment(const string& courseCode) const {
-        cout << "Students enrolled in " << courseCode << ":" << endl;
+    void displayCourseEnrollment(const string& courseCode, ReportWriter& out) const {
+        out << "Students enrolled in " << courseCode << ":\n";
         if (auto it = courseWiseEnrollment.find(courseCode); it != courseWiseEnrollment.end()) {
-            for (const auto& studentID : it->second) cout << "- " << studentID << endl;
+            for (const auto& studentID : it->second) out << "- " << studentID << '\n';
         } else {
-            cout << "No students enrolled in this course yet." << endl;
+            out << "No students enrolled in this course yet.\n";
         }
     }
 };
 // The main University system
+// Students and courses are also indexed by ID and code (their position in
+// studentsList and coursesList), and every enrollment is remembered as a
+// (course, student) position pair, so an enrollment is checked with three
+// hash lookups however many students and courses there are.
 class University {
     vector<Department> departmentsList;
     vector<Student*> studentsList;
     vector<Professor*> professorsList;
     vector<Course> coursesList;
+    unordered_map<string, size_t> studentIndex;
+    unordered_map<string, size_t> courseIndex;
+    unordered_set<uint64_t> enrolledPairs;  // course position << 32 | student position
     EnrollmentManager enrollmentMgr;
     GradeBook gradeBook;
 
 public:
+    // Room for that many students and courses without rehashing the indexes
+    void reserve(size_t students, size_t courses) {
+        studentsList.reserve(students);
+        studentIndex.reserve(students);
+        coursesList.reserve(courses);
+        courseIndex.reserve(courses);
+    }
+
     void addDepartment(const Department& d) {
         departmentsList.push_back(d);
     }
+    // Takes ownership of s, which is deleted if its ID is already taken
     void addStudent(Student* s) {
+        if (!studentIndex.emplace(s->getID(), studentsList.size()).second) {
+            string id = s->getID();
+            delete s;
+            throw UniSystemError("A student with ID " + id + " already exists.");
+        }
         studentsList.push_back(s);
     }
     void addProfessor(Professor* p) {
         professorsList.push_back(p);
     }
     void addCourse(const Course& c) {
+        if (!courseIndex.emplace(c.getCode(), coursesList.size()).second)
+            throw UniSystemError("A course with code " + c.getCode() + " already exists.");
         coursesList.push_back(c);
     }
 
-    void displayAllStudents() {
-        cout << "\n--- All Students ---" << endl;
+    void displayAllStudents(ReportWriter& out) {
+        out << "\n--- All Students ---\n";
         if (studentsList.empty()) {
-            cout << "No students in the system yet." << endl;
+            out << "No students in the system yet.\n";
             return;
         }
         for (const auto& student : studentsList) {
-            student->displayDetails();
-            cout << "----------------------" << endl;
+            student->displayDetails(out);
+            out << "----------------------\n";
         }
     }
 
-    void displayAllProfessors() {
-        cout << "\n--- All Professors ---" << endl;
+    void displayAllProfessors(ReportWriter& out) {
+        out << "\n--- All Professors ---\n";
         if (professorsList.empty()) {
-            cout << "No professors in the system yet." << endl;
+            out << "No professors in the system yet.\n";
             return;
         }
         for (const auto& professor : professorsList) {
-            professor->displayDetails();
-            cout << "------------------------" << endl;
+            professor->displayDetails(out);
+            out << "------------------------\n";
         }
     }
 
-    void displayAllCourses() {
-        cout << "\n--- All Courses ---" << endl;
+    void displayAllCourses(ReportWriter& out) {
+        out << "\n--- All Courses ---\n";
         if (coursesList.empty()) {
-            cout << "No courses in the system yet." << endl;
+            out << "No courses in the system yet.\n";
             return;
         }
         for (const auto& course : coursesList) {
-            course.displayDetails();
-            cout << "--------------------" << endl;
+            course.displayDetails(out);
+            out << "--------------------\n";
         }
     }
 
-    void enrollStudentInCourse(string studentID, string courseCode) {
+    // Throws EnrollIssue for an unknown student or course, or when the
+    // student is already enrolled in the course
+    void enrollStudentInCourse(const string& studentID, const string& courseCode) {
+        auto student = studentIndex.find(studentID);
+        if (student == studentIndex.end()) throw EnrollIssue("No student with ID " + studentID + ".");
+        auto course = courseIndex.find(courseCode);
+        if (course == courseIndex.end()) throw EnrollIssue("No course with code " + courseCode + ".");
+        if (!enrolledPairs.insert((uint64_t)course->second << 32 | student->second).second)
+            throw EnrollIssue("Student " + studentID + " is already enrolled in " + courseCode + ".");
         enrollmentMgr.enrollStudent(courseCode, studentID);
     }
 
-    void showCourseEnrollment(string courseCode) {
-        enrollmentMgr.displayCourseEnrollment(courseCode);
+    void showCourseEnrollment(string courseCode, ReportWriter& out) {
+        enrollmentMgr.displayCourseEnrollment(courseCode, out);
     }
 
     void recordStudentMarks(string studentID, float marks) {
         gradeBook.recordMarks(studentID, marks);
     }
 
-    void showStudentAverageMarks(string studentID) {
+    void showStudentAverageMarks(string studentID, ReportWriter& out) {
         try {
-            cout << "Average Marks for Student " << studentID << ": " << gradeBook.calculateAvgMarks(studentID) << endl;
+            out << "Average Marks for Student " << studentID << ": " << gradeBook.calculateAvgMarks(studentID) << '\n';
         } catch (const GradeProblem& e) {
+            out.flush(); // keep the buffered prefix ahead of the error, as cout's tie to cerr did
             cerr << "Error: " << e.what() << endl;
         }
     }
@@ -336,8 +370,51 @@ string getStringInput(const string& prompt) {
     return value;
 }
 
-int main() {
+// --bench-enroll [students] [courses] [per student] fills a University and
+// times validated enrollments, then the same enrollments again, which
+// must all be rejected as duplicates
+int runEnrollBench(int argc, char* argv[]) {
+    size_t students = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    size_t courses = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1000;
+    size_t perStudent = argc > 4 ? strtoull(argv[4], nullptr, 10) : 4;
+    University uni;
+    uni.reserve(students, courses);
+    vector<string> ids(students), codes(courses);
+    for (size_t i = 0; i < courses; ++i) {
+        codes[i] = "C" + to_string(i);
+        uni.addCourse(Course(codes[i], "Course " + to_string(i), 4));
+    }
+    for (size_t i = 0; i < students; ++i) {
+        ids[i] = "S" + to_string(i);
+        uni.addStudent(new UndergradStudent("Student", 20, ids[i], "-", "BTech", 3.0f, "2024", "CS", "none", "2028"));
+    }
+    auto pass = [&](const char* label) {
+        size_t accepted = 0, rejected = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < students; ++i) {
+            for (size_t k = 0; k < perStudent; ++k) {
+                try {
+                    uni.enrollStudentInCourse(ids[i], codes[(i * 7 + k * 13) % courses]);
+                    accepted++;
+                } catch (const EnrollIssue&) {
+                    rejected++;
+                }
+            }
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << label << ": " << (accepted + rejected) / seconds << " enrollments/s (" << accepted << " accepted, "
+             << rejected << " rejected)" << endl;
+    };
+    pass("new      ");
+    pass("duplicate");
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench-enroll") return runEnrollBench(argc, argv);
+
     University uni;
+    ReportWriter out;  // listings are buffered and flushed once per menu action
 
     int choice;
     do {
@@ -410,25 +487,26 @@ int main() {
                     break;
                 }
                 case 4:
-                    uni.displayAllStudents();
+                    uni.displayAllStudents(out);
                     break;
                 case 5:
-                    uni.displayAllProfessors();
+                    uni.displayAllProfessors(out);
                     break;
                 case 6:
-                    uni.displayAllCourses();
+                    uni.displayAllCourses(out);
                     break;
                 case 7: {
                     cout << "\n--- Enroll Student in Course ---" << endl;
                     string studentID = getStringInput("Enter student ID to enroll: ");
                     string courseCode = getStringInput("Enter course code to enroll in: ");
                     uni.enrollStudentInCourse(studentID, courseCode);
+                    cout << "Student " << studentID << " enrolled in course " << courseCode << endl;
                     break;
                     }
                     case 8: {
                     cout << "\n--- Show Course Enrollment ---" << endl;
                     string courseCode = getStringInput("Enter course code to view enrollment: ");
-                    uni.showCourseEnrollment(courseCode);
+                    uni.showCourseEnrollment(courseCode, out);
                     break;
                     }
                     case 9: {
@@ -442,7 +520,7 @@ break;
 case 10: {
 cout << "\n--- Show Student Average Marks ---" << endl;
 string studentID = getStringInput("Enter student ID to view average marks: ");
-uni.showStudentAverageMarks(studentID);
+uni.showStudentAverageMarks(studentID, out);
 break;
 }
 case 0:
@@ -452,8 +530,10 @@ default:
 cout << "Invalid choice. Please try again." << endl;
 }
 } catch (const UniSystemError& e) {
+out.flush();
 cerr << "Error Encountered: " << e.what() << endl;
 }
+out.flush();
 } while (choice != 0);
 
 return 0;
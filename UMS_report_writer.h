@@ -0,0 +1,18 @@
+#ifndef UMS_REPORT_WRITER_H
+#define UMS_REPORT_WRITER_H
+
+#include <string>
+#include "A1_fast_io.h"
+
+// Sink for the display and report methods: a FastWriter with a 1 MB
+// buffer, so a whole listing usually reaches standard output, the file
+// or the string in one write.
+class ReportWriter : public FastWriter
+{
+public:
+    explicit ReportWriter(int fd = 1) : FastWriter(fd, 1 << 20) {}
+    explicit ReportWriter(const std::string& path) : FastWriter(path, 1 << 20) {}
+    explicit ReportWriter(std::string* target) : FastWriter(target) {}
+};
+
+#endif